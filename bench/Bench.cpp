@@ -0,0 +1,100 @@
+#include "Bench.hpp"
+
+#include "core/Allocation.hpp"
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+constexpr std::size_t kMaxIterations = std::size_t{1} << 30;
+constexpr double kWallBudgetFactor = 10.0;
+} // namespace
+
+namespace bench {
+
+std::uint64_t allocationCount() { return core::threadAllocations().count; }
+std::uint64_t allocatedBytes() { return core::threadAllocations().bytes; }
+
+void State::start() {
+    m_running = true;
+    m_startAllocations = allocationCount();
+    m_startBytes = allocatedBytes();
+    m_startTime = std::chrono::steady_clock::now();
+}
+
+void State::stop() {
+    if (!m_running) return;
+    const auto now = std::chrono::steady_clock::now();
+    m_elapsed += std::chrono::duration<double>(now - m_startTime).count();
+    m_allocations += allocationCount() - m_startAllocations;
+    m_bytes += allocatedBytes() - m_startBytes;
+    m_running = false;
+}
+
+void State::pauseTiming() { stop(); }
+
+void State::resumeTiming() {
+    if (!m_running) start();
+}
+
+void Runner::add(std::string name, Body body) {
+    m_entries.push_back({std::move(name), std::move(body)});
+}
+
+std::vector<Result> Runner::run(const std::string& filter, double minSeconds, std::ostream& log) const {
+    std::vector<Result> results;
+    for (const auto& entry : m_entries) {
+        if (!filter.empty() && entry.name.find(filter) == std::string::npos) continue;
+        std::size_t iterations = 1;
+        for (;;) {
+            State state(iterations);
+            const auto wallStart = std::chrono::steady_clock::now();
+            entry.body(state);
+            const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+            const double elapsed = state.elapsedSeconds();
+            // Untimed setup can dominate; stop growing once the wall clock is well past the target.
+            if (elapsed >= minSeconds || wall >= kWallBudgetFactor * minSeconds || iterations >= kMaxIterations) {
+                Result result;
+                result.name = entry.name;
+                result.iterations = iterations;
+                const double ops = static_cast<double>(iterations);
+                result.nsPerOp = elapsed * 1e9 / ops;
+                result.itemsPerSecond = elapsed > 0.0 ? state.itemsPerIteration() * ops / elapsed : 0.0;
+                result.allocationsPerOp = static_cast<double>(state.allocations()) / ops;
+                result.bytesPerOp = static_cast<double>(state.bytes()) / ops;
+                results.push_back(result);
+                log << "." << std::flush;
+                break;
+            }
+            // Aim straight for the target once there is a usable measurement.
+            const double scale = elapsed > 1e-4 ? std::clamp(1.4 * minSeconds / elapsed, 2.0, 100.0) : 10.0;
+            iterations = std::min(kMaxIterations, static_cast<std::size_t>(static_cast<double>(iterations) * scale));
+        }
+    }
+    log << "\n";
+    return results;
+}
+
+void printTable(std::ostream& out, const std::vector<Result>& results) {
+    std::size_t nameWidth = 9;
+    for (const auto& result : results) nameWidth = std::max(nameWidth, result.name.size());
+    out << std::left << std::setw(static_cast<int>(nameWidth)) << "benchmark" << std::right << std::setw(12) << "iterations"
+        << std::setw(16) << "ns/op" << std::setw(16) << "items/sec" << std::setw(14) << "allocs/op" << std::setw(14)
+        << "bytes/op" << "\n";
+    out << std::fixed;
+    for (const auto& result : results) {
+        out << std::left << std::setw(static_cast<int>(nameWidth)) << result.name << std::right << std::setw(12)
+            << result.iterations << std::setw(16) << std::setprecision(1) << result.nsPerOp << std::setw(16)
+            << std::setprecision(0) << result.itemsPerSecond << std::setw(14) << std::setprecision(2)
+            << result.allocationsPerOp << std::setw(14) << std::setprecision(0) << result.bytesPerOp << "\n";
+    }
+}
+
+void writeCsv(std::ostream& out, const std::vector<Result>& results) {
+    out << "benchmark,iterations,nsPerOp,itemsPerSecond,allocationsPerOp,bytesPerOp\n";
+    for (const auto& result : results) {
+        out << result.name << ',' << result.iterations << ',' << result.nsPerOp << ',' << result.itemsPerSecond << ','
+            << result.allocationsPerOp << ',' << result.bytesPerOp << '\n';
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// Allocation counters of the calling thread, fed by core/Allocation.cpp.
+std::uint64_t allocationCount();
+std::uint64_t allocatedBytes();
+
+// Passed to every benchmark body. The body runs `while (state.keepRunning())`
+// and may pause the clock around setup that should not be measured; allocations
+// made while paused are not counted either.
+class State {
+public:
+    explicit State(std::size_t iterations) : m_iterations(iterations) {}
+
+    bool keepRunning() {
+        if (m_done == 0 && !m_running) {
+            start();
+        }
+        if (m_done == m_iterations) {
+            stop();
+            return false;
+        }
+        ++m_done;
+        return true;
+    }
+
+    void pauseTiming();
+    void resumeTiming();
+
+    // Items processed per iteration (entities, queries, bytes...); used for items/sec.
+    void setItemsPerIteration(double items) { m_itemsPerIteration = items; }
+
+    std::size_t iterations() const { return m_iterations; }
+    double elapsedSeconds() const { return m_elapsed; }
+    std::uint64_t allocations() const { return m_allocations; }
+    std::uint64_t bytes() const { return m_bytes; }
+    double itemsPerIteration() const { return m_itemsPerIteration; }
+
+private:
+    void start();
+    void stop();
+
+    std::size_t m_iterations;
+    std::size_t m_done = 0;
+    bool m_running = false;
+    std::chrono::steady_clock::time_point m_startTime;
+    std::uint64_t m_startAllocations = 0;
+    std::uint64_t m_startBytes = 0;
+    double m_elapsed = 0.0;
+    std::uint64_t m_allocations = 0;
+    std::uint64_t m_bytes = 0;
+    double m_itemsPerIteration = 1.0;
+};
+
+struct Result {
+    std::string name;
+    std::size_t iterations = 0;
+    double nsPerOp = 0.0;
+    double itemsPerSecond = 0.0;
+    double allocationsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+};
+
+class Runner {
+public:
+    using Body = std::function<void(State&)>;
+
+    void add(std::string name, Body body);
+
+    // Runs every benchmark whose name contains `filter`. Iterations are doubled
+    // until the measured time reaches `minSeconds`.
+    std::vector<Result> run(const std::string& filter, double minSeconds, std::ostream& log) const;
+
+private:
+    struct Entry {
+        std::string name;
+        Body body;
+    };
+    std::vector<Entry> m_entries;
+};
+
+void printTable(std::ostream& out, const std::vector<Result>& results);
+void writeCsv(std::ostream& out, const std::vector<Result>& results);
+
+// Keeps the optimizer from discarding a computed value.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace bench
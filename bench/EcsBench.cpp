@@ -0,0 +1,113 @@
+#include "Suites.hpp"
+
+#include "ecs/Registry.hpp"
+#include "math/SpatialHash.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+namespace {
+
+constexpr std::size_t kEntityCounts[] = {1000, 10000, 50000};
+constexpr std::size_t kQueryCount = 1024;
+
+std::vector<sf::Vector2f> randomPositions(std::size_t count, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> x(0.f, 1280.f);
+    std::uniform_real_distribution<float> y(0.f, 720.f);
+    std::vector<sf::Vector2f> out(count);
+    for (auto& p : out) p = {x(rng), y(rng)};
+    return out;
+}
+
+void populate(ecs::Registry& registry, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        ecs::Entity e = registry.create();
+        registry.m_transforms[e].position = {static_cast<float>(i % 1280), static_cast<float>(i % 720)};
+        registry.m_health[e] = {100.f, 100.f};
+        registry.m_enemyStats[e].speed = 60.f;
+    }
+}
+
+} // namespace
+
+void registerEcsBenchmarks(Runner& runner) {
+    for (std::size_t count : kEntityCounts) {
+        const std::string suffix = "/entities=" + std::to_string(count);
+
+        runner.add("ecs/Registry/create" + suffix, [count](State& state) {
+            state.setItemsPerIteration(static_cast<double>(count));
+            while (state.keepRunning()) {
+                ecs::Registry registry;
+                populate(registry, count);
+                doNotOptimize(registry.m_transforms.size());
+                state.pauseTiming();
+                registry = ecs::Registry{};
+                state.resumeTiming();
+            }
+        });
+
+        runner.add("ecs/Registry/destroy" + suffix, [count](State& state) {
+            state.setItemsPerIteration(static_cast<double>(count));
+            ecs::Registry registry;
+            while (state.keepRunning()) {
+                state.pauseTiming();
+                registry = ecs::Registry{};
+                populate(registry, count);
+                state.resumeTiming();
+                for (ecs::Entity e = 1; e <= static_cast<ecs::Entity>(count); ++e) {
+                    registry.destroy(e);
+                }
+            }
+        });
+
+        runner.add("ecs/Registry/iterate" + suffix, [count](State& state) {
+            ecs::Registry registry;
+            state.pauseTiming();
+            populate(registry, count);
+            state.resumeTiming();
+            state.setItemsPerIteration(static_cast<double>(count));
+            while (state.keepRunning()) {
+                float sum = 0.f;
+                for (const auto& [entity, stats] : registry.m_enemyStats) {
+                    sum += registry.m_transforms[entity].position.x * stats.speed;
+                    sum += registry.m_health[entity].hp;
+                }
+                doNotOptimize(sum);
+            }
+        });
+
+        runner.add("math/SpatialHashGrid/insert" + suffix, [count](State& state) {
+            const auto positions = randomPositions(count, 7);
+            math::SpatialHashGrid grid;
+            state.setItemsPerIteration(static_cast<double>(count));
+            while (state.keepRunning()) {
+                grid.clear();
+                for (std::size_t i = 0; i < positions.size(); ++i) {
+                    grid.insert(i, positions[i]);
+                }
+            }
+        });
+
+        runner.add("math/SpatialHashGrid/query" + suffix, [count](State& state) {
+            const auto positions = randomPositions(count, 7);
+            const auto queries = randomPositions(kQueryCount, 11);
+            math::SpatialHashGrid grid;
+            for (std::size_t i = 0; i < positions.size(); ++i) {
+                grid.insert(i, positions[i]);
+            }
+            state.setItemsPerIteration(static_cast<double>(kQueryCount));
+            while (state.keepRunning()) {
+                std::size_t hits = 0;
+                for (const auto& q : queries) {
+                    grid.query(q, [&](std::size_t) { ++hits; });
+                }
+                doNotOptimize(hits);
+            }
+        });
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,125 @@
+#include "Suites.hpp"
+
+#include "core/Json.hpp"
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <nlohmann/json.hpp>
+
+namespace bench {
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return {};
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+constexpr std::size_t kLevelSetBytes = 50 * 1024 * 1024;
+
+void addParseBenchmark(Runner& runner, const std::string& name, std::string text) {
+    auto shared = std::make_shared<const std::string>(std::move(text));
+    runner.add("json/parse/" + name, [shared](State& state) {
+        // Items are bytes, so items/sec reads as parse throughput.
+        state.setItemsPerIteration(static_cast<double>(shared->size()));
+        while (state.keepRunning()) {
+            auto value = nlohmann::json::parse(*shared);
+            doNotOptimize(value);
+        }
+    });
+    runner.add("json/document/" + name, [shared](State& state) {
+        state.setItemsPerIteration(static_cast<double>(shared->size()));
+        while (state.keepRunning()) {
+            auto document = core::JsonDocument::parse(*shared);
+            doNotOptimize(document.root());
+        }
+    });
+}
+
+// Levels shaped like data/levels/*.json, with long paths and cell lists,
+// concatenated into one {"levels": [...]} document of at least `bytes`.
+std::string syntheticLevelSet(std::size_t bytes) {
+    std::uint32_t seed = 0x2545f491u;
+    auto next = [&seed](std::uint32_t bound) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed % bound;
+    };
+    std::string out = "{\"levels\": [";
+    out.reserve(bytes + 64 * 1024);
+    for (int level = 0; out.size() < bytes; ++level) {
+        if (level > 0) out += ",";
+        const std::string id = "level_" + std::to_string(level);
+        out += "\n  {\"id\": \"" + id + "\", \"name\": \"Synthetic \\\"" + id + "\\\"\", \"biome\": \"grass\",";
+        out += " \"grid\": {\"width\": 64, \"height\": 36, \"tileSize\": 40}, \"paths\": [{\"points\": [";
+        for (int i = 0; i < 200; ++i) {
+            out += (i ? ", [" : "[") + std::to_string(next(64)) + ", " + std::to_string(next(36)) + "]";
+        }
+        out += "]}], \"buildable\": [";
+        for (int i = 0; i < 400; ++i) {
+            out += (i ? ", [" : "[") + std::to_string(next(64)) + ", " + std::to_string(next(36)) + "]";
+        }
+        out += "], \"obstacles\": [], \"rules\": [\"noFlying\", \"double_gold\"], \"waves\": \"" + id + "\",";
+        out += " \"startCoins\": " + std::to_string(200 + next(400)) + ", \"startLives\": 20,";
+        out += " \"modifiers\": {\"hp\": 1." + std::to_string(next(1000)) + ", \"speed\": 0.9" + std::to_string(next(100)) +
+               ", \"reward\": 2.5e-1}}";
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+void addLevelSetBenchmarks(Runner& runner) {
+    // Built on first use, so that filtered runs that skip these never pay for 50 MB of text.
+    auto text = std::make_shared<std::string>();
+    auto ensure = [text]() -> const std::string& {
+        if (text->empty()) *text = syntheticLevelSet(kLevelSetBytes);
+        return *text;
+    };
+    runner.add("json/levelset50mb/nlohmann", [ensure](State& state) {
+        const std::string& input = ensure();
+        state.setItemsPerIteration(static_cast<double>(input.size()));
+        while (state.keepRunning()) {
+            auto value = nlohmann::json::parse(input);
+            doNotOptimize(value);
+        }
+    });
+    runner.add("json/levelset50mb/document", [ensure](State& state) {
+        const std::string& input = ensure();
+        state.setItemsPerIteration(static_cast<double>(input.size()));
+        while (state.keepRunning()) {
+            auto document = core::JsonDocument::parse(input);
+            doNotOptimize(document.root());
+        }
+    });
+    // Tokenizing alone, as a reader that picks out a few fields would.
+    runner.add("json/levelset50mb/pull", [ensure](State& state) {
+        const std::string& input = ensure();
+        state.setItemsPerIteration(static_cast<double>(input.size()));
+        while (state.keepRunning()) {
+            core::JsonReader reader(input);
+            std::size_t events = 0;
+            while (reader.next() != core::JsonReader::Event::End) ++events;
+            doNotOptimize(events);
+        }
+    });
+}
+
+} // namespace
+
+void registerJsonBenchmarks(Runner& runner, const std::string& dataPath) {
+    for (const char* file : {"towers.json", "enemies.json", "waves.json", "levels/level_12.json"}) {
+        std::string text = readFile(dataPath + "/" + file);
+        if (text.empty()) {
+            std::cerr << "[Bench] Skipping json/parse/" << file << ": could not read " << dataPath << "/" << file << "\n";
+            continue;
+        }
+        addParseBenchmark(runner, file, std::move(text));
+    }
+    addLevelSetBenchmarks(runner);
+}
+
+} // namespace bench
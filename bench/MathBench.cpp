@@ -0,0 +1,45 @@
+#include "Suites.hpp"
+
+#include "math/MathUtils.hpp"
+#include "math/Path.hpp"
+
+namespace bench {
+
+namespace {
+constexpr int kPathPoints = 64;
+constexpr int kSamplesPerOp = 1024;
+} // namespace
+
+void registerMathBenchmarks(Runner& runner) {
+    runner.add("math/Path/samplePath", [](State& state) {
+        math::Path path;
+        for (int i = 0; i < kPathPoints; ++i) {
+            path.points.push_back({static_cast<float>(i * 20), static_cast<float>((i % 2) * 300)});
+        }
+        state.setItemsPerIteration(kSamplesPerOp);
+        while (state.keepRunning()) {
+            sf::Vector2f acc{0.f, 0.f};
+            for (int i = 0; i < kSamplesPerOp; ++i) {
+                acc += math::samplePath(path, i % (kPathPoints - 1), static_cast<float>(i & 15) / 15.f);
+            }
+            doNotOptimize(acc);
+        }
+    });
+
+    runner.add("math/Path/pathSegmentLength", [](State& state) {
+        math::Path path;
+        for (int i = 0; i < kPathPoints; ++i) {
+            path.points.push_back({static_cast<float>(i * 20), static_cast<float>((i % 2) * 300)});
+        }
+        state.setItemsPerIteration(kSamplesPerOp);
+        while (state.keepRunning()) {
+            float total = 0.f;
+            for (int i = 0; i < kSamplesPerOp; ++i) {
+                total += math::pathSegmentLength(path, i % (kPathPoints - 1));
+            }
+            doNotOptimize(total);
+        }
+    });
+}
+
+} // namespace bench
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Bench.hpp"
+#include <string>
+
+namespace bench {
+
+void registerEcsBenchmarks(Runner& runner);
+void registerSystemsBenchmarks(Runner& runner);
+void registerMathBenchmarks(Runner& runner);
+void registerJsonBenchmarks(Runner& runner, const std::string& dataPath);
+
+} // namespace bench
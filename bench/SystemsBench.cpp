@@ -0,0 +1,124 @@
+#include "Suites.hpp"
+#include "World.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+namespace {
+
+constexpr float kDt = 1.f / 60.f;
+constexpr std::size_t kEnemyCounts[] = {100, 1000, 10000, 50000};
+constexpr std::pair<std::size_t, std::size_t> kMixes[] = {{100, 10}, {1000, 100}, {10000, 100}, {50000, 1000}};
+// Ticks between untimed world rebuilds for systems that consume their input.
+constexpr std::size_t kRebuildInterval = 64;
+
+std::string mixName(const char* system, std::size_t enemies, std::size_t towers) {
+    return std::string("systems/") + system + "/enemies=" + std::to_string(enemies) + ",towers=" + std::to_string(towers);
+}
+
+} // namespace
+
+void registerSystemsBenchmarks(Runner& runner) {
+    for (std::size_t enemies : kEnemyCounts) {
+        runner.add("systems/updateMovement/enemies=" + std::to_string(enemies), [enemies](State& state) {
+            auto world = std::make_unique<World>();
+            std::size_t tick = 0;
+            state.setItemsPerIteration(static_cast<double>(enemies));
+            while (state.keepRunning()) {
+                if (tick++ % kRebuildInterval == 0) {
+                    state.pauseTiming();
+                    buildWorld(*world, {enemies, 0, false, false});
+                    state.resumeTiming();
+                }
+                int livesLost = 0;
+                systems::updateMovement(world->registry, world->paths, kDt, 40.f, livesLost);
+                doNotOptimize(livesLost);
+            }
+        });
+
+        runner.add("systems/updateStatus/enemies=" + std::to_string(enemies), [enemies](State& state) {
+            auto world = std::make_unique<World>();
+            state.pauseTiming();
+            buildWorld(*world, {enemies, 0, true, false});
+            state.resumeTiming();
+            state.setItemsPerIteration(static_cast<double>(enemies));
+            while (state.keepRunning()) {
+                systems::updateStatus(world->registry, kDt, world->balance);
+            }
+        });
+
+        runner.add("systems/updateCleanup/enemies=" + std::to_string(enemies), [enemies](State& state) {
+            auto world = std::make_unique<World>();
+            std::size_t tick = 0;
+            state.setItemsPerIteration(static_cast<double>(enemies));
+            while (state.keepRunning()) {
+                state.pauseTiming();
+                if (tick++ % kRebuildInterval == 0) {
+                    buildWorld(*world, {enemies, 0, false, false});
+                }
+                // Kill roughly 1% of the population each tick.
+                std::size_t index = 0;
+                for (auto& [entity, health] : world->registry.m_health) {
+                    if (index++ % 100 == 0) health.hp = 0.f;
+                }
+                state.resumeTiming();
+                systems::updateCleanup(world->registry, world->projectilePool, world->particles);
+            }
+        });
+    }
+
+    for (const auto& [enemies, towers] : kMixes) {
+        runner.add(mixName("updateTargeting", enemies, towers), [enemies = enemies, towers = towers](State& state) {
+            auto world = std::make_unique<World>();
+            state.pauseTiming();
+            buildWorld(*world, {enemies, towers, false, false});
+            state.resumeTiming();
+            state.setItemsPerIteration(static_cast<double>(towers));
+            while (state.keepRunning()) {
+                systems::updateTargeting(world->registry, world->grid, world->enemyOrder, kDt);
+            }
+        });
+
+        runner.add(mixName("updateFiring", enemies, towers), [enemies = enemies, towers = towers](State& state) {
+            auto world = std::make_unique<World>();
+            state.pauseTiming();
+            buildWorld(*world, {enemies, towers, false, false});
+            systems::updateTargeting(world->registry, world->grid, world->enemyOrder, kDt);
+            state.resumeTiming();
+            state.setItemsPerIteration(static_cast<double>(towers));
+            std::vector<ecs::Entity> spawned;
+            while (state.keepRunning()) {
+                state.pauseTiming();
+                for (auto& [entity, tower] : world->registry.m_towerStats) tower.cooldown = 0.f;
+                spawned.clear();
+                for (const auto& [entity, projectile] : world->registry.m_projectiles) spawned.push_back(entity);
+                for (auto entity : spawned) {
+                    world->registry.destroy(entity);
+                    world->projectilePool.available.push_back(entity);
+                }
+                state.resumeTiming();
+                systems::updateFiring(world->registry, world->projectilePool, kDt, world->balance);
+            }
+        });
+
+        runner.add(mixName("updateProjectiles", enemies, towers), [enemies = enemies, towers = towers](State& state) {
+            auto world = std::make_unique<World>();
+            std::size_t tick = 0;
+            state.setItemsPerIteration(static_cast<double>(towers));
+            while (state.keepRunning()) {
+                if (tick++ % kRebuildInterval == 0) {
+                    state.pauseTiming();
+                    buildWorld(*world, {enemies, towers, true, true});
+                    state.resumeTiming();
+                }
+                systems::updateProjectiles(world->registry, world->particles, kDt, world->balance);
+            }
+        });
+    }
+}
+
+} // namespace bench
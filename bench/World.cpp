@@ -0,0 +1,102 @@
+#include "World.hpp"
+
+#include "entities/Entities.hpp"
+#include "math/MathUtils.hpp"
+#include <random>
+
+namespace bench {
+
+namespace {
+constexpr std::uint32_t kWorldSeed = 1234;
+constexpr float kWidth = 1280.f;
+constexpr float kHeight = 720.f;
+constexpr int kZigZags = 10;
+} // namespace
+
+void buildWorld(World& world, const WorldOptions& options) {
+    world.registry = ecs::Registry{};
+    world.projectilePool.available.clear();
+    world.particles.clear();
+    world.enemyOrder.clear();
+    world.grid.clear();
+
+    math::Path path;
+    for (int i = 0; i <= kZigZags; ++i) {
+        const float x = 20.f + (kWidth - 40.f) * static_cast<float>(i) / kZigZags;
+        path.points.push_back({x, i % 2 == 0 ? 80.f : kHeight - 80.f});
+    }
+    world.paths.paths = {path};
+
+    world.balance.statuses["slow"] = data::StatusDefinition{0.65f, 2.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+    world.balance.statuses["burn"] = data::StatusDefinition{1.f, 3.f, 6.f, 0.f, 0.f, 0.f, 0.f};
+
+    std::mt19937 rng(kWorldSeed);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+    data::EnemyDefinition enemyDef;
+    enemyDef.id = "bench_enemy";
+    enemyDef.hp = 1e6f;
+    enemyDef.speed = 60.f;
+    enemyDef.armor = 5.f;
+    enemyDef.abilities = {"none"};
+    enemyDef.tags = {"ground"};
+    const int segments = static_cast<int>(path.points.size()) - 1;
+    for (std::size_t i = 0; i < options.enemies; ++i) {
+        ecs::Entity e = entities::spawnEnemy(world.registry, enemyDef, path);
+        auto& stats = world.registry.m_enemyStats[e];
+        // Keep clear of the exit so movement benchmarks do not drain the population.
+        const float along = unit(rng) * 0.8f * static_cast<float>(segments);
+        stats.waypoint = static_cast<int>(along);
+        stats.progress = along - static_cast<float>(stats.waypoint);
+        world.registry.m_transforms[e].position =
+            math::lerp(path.points[stats.waypoint], path.points[stats.waypoint + 1], stats.progress);
+        if (options.statuses) {
+            auto& active = world.registry.m_statusContainers[e].active;
+            active.push_back({"slow", 0.3f, 1e6f, 1e6f, 1});
+            active.push_back({"burn", 0.f, 1e6f, 1e6f, 1});
+        }
+    }
+
+    data::TowerDefinition towerDef;
+    towerDef.id = "bench_tower";
+    towerDef.damage = 10.f;
+    towerDef.fireRate = 2.f;
+    towerDef.range = 130.f;
+    towerDef.statusEffect = "slow";
+    towerDef.statusPotency = 0.1f;
+    towerDef.statusDuration = 1.f;
+    std::vector<ecs::Entity> enemies;
+    enemies.reserve(options.enemies);
+    for (const auto& [entity, stats] : world.registry.m_enemyStats) enemies.push_back(entity);
+    for (std::size_t i = 0; i < options.towers; ++i) {
+        const float along = unit(rng) * static_cast<float>(segments);
+        const int seg = static_cast<int>(along);
+        sf::Vector2f position = math::lerp(path.points[seg], path.points[seg + 1], along - static_cast<float>(seg));
+        position += sf::Vector2f{(unit(rng) - 0.5f) * 120.f, (unit(rng) - 0.5f) * 120.f};
+        entities::spawnTower(world.registry, towerDef, position);
+        if (options.projectiles && !enemies.empty()) {
+            ecs::Entity projectileEntity = world.registry.create();
+            world.registry.m_transforms[projectileEntity].position = position;
+            auto& projectile = world.registry.m_projectiles[projectileEntity];
+            projectile.speed = 420.f;
+            projectile.damage = towerDef.damage;
+            projectile.range = 1e6f;
+            projectile.target = enemies[i % enemies.size()];
+            projectile.statusEffect = towerDef.statusEffect;
+            projectile.statusPower = towerDef.statusPotency;
+            projectile.statusDuration = towerDef.statusDuration;
+        }
+    }
+    rebuildGrid(world);
+}
+
+void rebuildGrid(World& world) {
+    world.grid.clear();
+    world.enemyOrder.clear();
+    for (const auto& [entity, stats] : world.registry.m_enemyStats) {
+        world.enemyOrder.push_back(entity);
+        world.grid.insert(world.enemyOrder.size() - 1, world.registry.m_transforms[entity].position);
+    }
+}
+
+} // namespace bench
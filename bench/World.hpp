@@ -0,0 +1,36 @@
+#pragma once
+
+#include "core/GameData.hpp"
+#include "ecs/Registry.hpp"
+#include "math/SpatialHash.hpp"
+#include "systems/Systems.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace bench {
+
+// Deterministic synthetic battlefield: enemies spread along a zig-zag path and
+// towers scattered beside it. The same counts always produce the same world.
+struct World {
+    ecs::Registry registry;
+    systems::PathContext paths;
+    systems::ProjectilePool projectilePool;
+    systems::ParticleSystem particles;
+    math::SpatialHashGrid grid;
+    std::vector<ecs::Entity> enemyOrder;
+    data::BalanceDefinition balance;
+};
+
+struct WorldOptions {
+    std::size_t enemies = 0;
+    std::size_t towers = 0;
+    bool statuses = false;    // give every enemy a slow and a burn
+    bool projectiles = false; // one projectile in flight per tower
+};
+
+void buildWorld(World& world, const WorldOptions& options);
+
+// Mirrors the per-tick spatial index rebuild in core::Simulation.
+void rebuildGrid(World& world);
+
+} // namespace bench
@@ -0,0 +1,49 @@
+// Microbenchmarks for the ECS, gameplay systems, math helpers and JSON parser.
+//
+// Usage: towerdefense_bench [--filter SUBSTRING] [--min-time SECONDS] [--data DIR] [--csv FILE]
+
+#include "Suites.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string dataPath = "data";
+    std::string csvPath;
+    double minSeconds = 0.2;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+                return argv[++i];
+            };
+            if (arg == "--filter") filter = next();
+            else if (arg == "--min-time") minSeconds = std::stod(next());
+            else if (arg == "--data") dataPath = next();
+            else if (arg == "--csv") csvPath = next();
+            else throw std::runtime_error("Unknown argument: " + arg);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Bench] " << e.what() << "\n"
+                  << "Usage: towerdefense_bench [--filter SUBSTRING] [--min-time SECONDS] [--data DIR] [--csv FILE]\n";
+        return 1;
+    }
+
+    bench::Runner runner;
+    bench::registerEcsBenchmarks(runner);
+    bench::registerSystemsBenchmarks(runner);
+    bench::registerMathBenchmarks(runner);
+    bench::registerJsonBenchmarks(runner, dataPath);
+
+    const auto results = runner.run(filter, minSeconds, std::cerr);
+    bench::printTable(std::cout, results);
+    if (!csvPath.empty()) {
+        std::ofstream csv(csvPath);
+        bench::writeCsv(csv, results);
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "Allocation.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace core {
+
+namespace {
+constexpr int kReportedTagCapacity = 64;
+
+struct ThreadAllocationState {
+    AllocationCounters counters;
+    const char* tag = nullptr;
+    int auditDepth = 0;
+    bool reporting = false;
+    std::uint64_t violations = 0;
+    const char* reportedTags[kReportedTagCapacity] = {};
+    int reportedTagCount = 0;
+};
+
+thread_local ThreadAllocationState t_state;
+
+AllocationAuditMode readAuditMode() {
+    const char* value = std::getenv("TOWERDEFENSE_ALLOC_AUDIT");
+    if (!value || !*value || std::strcmp(value, "0") == 0) return AllocationAuditMode::Off;
+    if (std::strcmp(value, "abort") == 0) return AllocationAuditMode::Abort;
+    return AllocationAuditMode::Report;
+}
+
+// Runs inside operator new: must not allocate, so it only touches stderr and
+// a fixed-size table, with `reporting` guarding against re-entry.
+void reportViolation(std::size_t size) {
+    ThreadAllocationState& state = t_state;
+    ++state.violations;
+    if (state.reporting) return;
+    state.reporting = true;
+    const char* tag = state.tag ? state.tag : "untagged";
+    bool seen = false;
+    for (int i = 0; i < state.reportedTagCount; ++i) {
+        if (state.reportedTags[i] == tag) seen = true;
+    }
+    const AllocationAuditMode mode = allocationAuditMode();
+    if (!seen || mode == AllocationAuditMode::Abort) {
+        if (!seen && state.reportedTagCount < kReportedTagCapacity) {
+            state.reportedTags[state.reportedTagCount++] = tag;
+        }
+        std::fprintf(stderr, "[Alloc] %zu byte allocation in '%s' during a warm gameplay tick\n", size, tag);
+    }
+    if (mode == AllocationAuditMode::Abort) std::abort();
+    state.reporting = false;
+}
+
+void* allocate(std::size_t size) {
+    ThreadAllocationState& state = t_state;
+    ++state.counters.count;
+    state.counters.bytes += size;
+    if (state.auditDepth > 0) reportViolation(size);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+} // namespace
+
+AllocationCounters threadAllocations() {
+    return t_state.counters;
+}
+
+const char* setAllocationTag(const char* tag) {
+    const char* previous = t_state.tag;
+    t_state.tag = tag;
+    return previous;
+}
+
+AllocationAuditMode allocationAuditMode() {
+    static const AllocationAuditMode mode = readAuditMode();
+    return mode;
+}
+
+AllocationAudit::AllocationAudit(bool armed) : m_armed(armed && allocationAuditMode() != AllocationAuditMode::Off) {
+    if (m_armed) ++t_state.auditDepth;
+}
+
+AllocationAudit::~AllocationAudit() {
+    if (m_armed) --t_state.auditDepth;
+}
+
+std::uint64_t allocationAuditViolations() {
+    return t_state.violations;
+}
+
+} // namespace core
+
+void* operator new(std::size_t size) { return core::allocate(size); }
+void* operator new[](std::size_t size) { return core::allocate(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+namespace core {
+
+// Counting hook behind the global operator new replacement in Allocation.cpp.
+// Counters are per thread, so reading them never contends with other threads.
+struct AllocationCounters {
+    std::uint64_t count = 0;
+    std::uint64_t bytes = 0;
+};
+
+// Allocations made by the calling thread since it started.
+AllocationCounters threadAllocations();
+
+// Innermost tag (a string literal, normally the active profiler scope) used to
+// attribute allocations in audit reports. Returns the previous tag.
+const char* setAllocationTag(const char* tag);
+
+enum class AllocationAuditMode { Off, Report, Abort };
+
+// From TOWERDEFENSE_ALLOC_AUDIT: unset/0 = Off, "abort" = Abort, anything else = Report.
+AllocationAuditMode allocationAuditMode();
+
+// While an armed audit is alive on a thread, every allocation on that thread is
+// a violation: it is counted, the first one per tag is written to stderr, and in
+// Abort mode the process stops. Audits do nothing when the mode is Off.
+class AllocationAudit {
+public:
+    explicit AllocationAudit(bool armed);
+    ~AllocationAudit();
+
+    AllocationAudit(const AllocationAudit&) = delete;
+    AllocationAudit& operator=(const AllocationAudit&) = delete;
+
+private:
+    bool m_armed = false;
+};
+
+// Violations seen on the calling thread.
+std::uint64_t allocationAuditViolations();
+
+} // namespace core
@@ -1,9 +1,17 @@
 #include "App.hpp"
 
+#include "DataPack.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <ctime>
 #include <filesystem>
 #include <iostream>
+#include <map>
 #include <stdexcept>
+#include <string>
+#include <thread>
 
 namespace {
 
@@ -46,11 +54,36 @@ std::filesystem::path resolveAssetsPath(const std::filesystem::path& projectRoot
     return projectRoot / "assets";
 }
 
+void registerAtlasImages(core::ResourceManager& resources, const data::GameDatabase& database,
+                         const core::LevelCatalog& levels) {
+    // std::map keeps registration order, and with it the atlas cache key, independent of hash map order.
+    std::map<std::string, std::string> images{{"tiles", "textures/placeholder.png"}, {"ui", "textures/placeholder.png"}};
+    for (const auto& level : levels.headers()) {
+        if (!level.biome.empty()) images["tiles_" + level.biome] = "textures/tiles/" + level.biome + ".png";
+    }
+    for (const auto& [id, tower] : database.towers) images["tower_" + id] = "textures/towers/" + id + ".png";
+    for (const auto& [id, enemy] : database.enemies) images["enemy_" + id] = "textures/enemies/" + id + ".png";
+    for (const auto& [id, path] : images) resources.registerAtlasImage(id, path);
+}
+
+#if TD_PROFILER
+std::string timestampedName(const char* prefix, const char* extension) {
+    const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", std::localtime(&now));
+    return std::string(prefix) + stamp + extension;
+}
+#endif
+
 } // namespace
 
 namespace core {
 
 App::App() {
+    m_startupBegin = std::chrono::steady_clock::now();
+    Trace::get().startFromEnvironment();
+    Trace::get().setThreadName("main");
+    TD_TRACE_SCOPE("startup", "App::App");
     m_window.create(sf::VideoMode(1280, 720), "TowerDefense", sf::Style::Default);
     m_window.setFramerateLimit(60);
     m_projectRoot = findProjectRoot();
@@ -61,21 +94,133 @@ App::App() {
                   << "'. Procedural placeholders will be used.\n";
     }
     m_resources.setAssetRoot(m_assetsPath);
-    m_resources.loadTexture("tiles", "textures/placeholder.png");
-    m_resources.loadTexture("ui", "textures/placeholder.png");
-    m_resources.loadSound("click", "audio/placeholder.wav");
+    // The font is all the main menu needs; everything else loads behind it.
     m_resources.loadFont("default", "fonts/DejaVuSans.ttf");
-    m_database = m_loader.loadAll(m_dataPath.string());
-    m_game = std::make_unique<Game>(m_resources, m_database);
+    {
+        TD_TRACE_SCOPE("startup", "Game::Game");
+        m_game = std::make_unique<Game>(m_resources, m_database);
+        m_game->setScreenSize(m_window.getDefaultView().getSize());
+    }
+#if TD_PROFILER
+    m_profilerOverlay.init(m_resources.font("default"));
+#endif
+    scheduleStartup();
+}
+
+void App::scheduleStartup() {
+    m_loader.setPackPath(dataPackPath(m_projectRoot, m_dataPath));
+    // Levels are listed from their headers here and parsed only when played.
+    m_loader.setLoadLevels(false);
+    m_levels = std::make_unique<LevelCatalog>(m_dataPath / "levels");
+    m_startup = std::make_unique<TaskGraph>();
+    const TaskGraph::TaskId data = m_loader.schedule(*m_startup, m_dataPath.string(), m_database);
+    const TaskGraph::TaskId levels = m_startup->add("level catalog", [this]() { m_levels->scan(); });
+    // Streamed by the resource manager's own workers; nothing waits for them.
+    m_resources.requestTexture("ui", "textures/placeholder.png");
+    m_resources.requestSound("click", "audio/placeholder.wav");
+    // The atlas holds one image per biome, tower and enemy, so it waits for the data.
+    m_startup->add("texture atlas", [this]() {
+        registerAtlasImages(m_resources, m_database, *m_levels);
+        m_resources.prepareAtlas(m_projectRoot / "cache" / "atlas");
+    }, {data, levels});
+    m_startupJobs = std::make_unique<JobSystem>();
+    m_startup->start(*m_startupJobs);
+}
+
+void App::pollStartup() {
+    switch (m_startupStage.load(std::memory_order_acquire)) {
+        case StartupStage::Loading: {
+            const std::size_t completed = m_startup->completed();
+            const std::string running = m_startup->running();
+            m_game->setLoadingProgress(static_cast<float>(completed) / static_cast<float>(m_startup->size()),
+                                       running.empty() ? "Loading" : "Loading " + running);
+            if (!m_startup->finished()) return;
+            m_startup->rethrowError();
+            m_game->setLoadingProgress(1.f, "Loading textures");
+            m_startupStage.store(StartupStage::Uploading, std::memory_order_release);
+            return;
+        }
+        case StartupStage::Finishing:
+            if (m_startupError) std::rethrow_exception(m_startupError);
+            finishStartup();
+            return;
+        default:
+            return;
+    }
+}
+
+void App::finishStartup() {
+    TD_TRACE_SCOPE("startup", "App::finishStartup");
+    m_thumbnails = std::make_unique<ThumbnailCache>(m_projectRoot / "cache" / "thumbnails");
+    m_game->finishLoading(*m_levels, m_thumbnails.get());
+    HitchConfig hitchConfig;
+    hitchConfig.budgetMs = m_database.settings.hitchBudgetMs;
+    hitchConfig.historyFrames = static_cast<std::size_t>(std::max(1, m_database.settings.hitchHistoryFrames));
+    hitchConfig.directory = m_projectRoot / "captures";
+    m_hitches = std::make_unique<HitchDetector>(hitchConfig);
+    m_hotReload = std::make_unique<DataHotReload>(m_dataPath);
+
+    const double loadedMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_startupBegin).count();
+    std::cerr << "[Startup] Loaded " << m_startup->size() << " tasks on " << m_startupJobs->workerCount()
+              << " workers; ready after " << loadedMs << " ms\n";
+    m_startupJobs.reset();
+    m_startup.reset();
+    m_startupStage.store(StartupStage::Done, std::memory_order_release);
 }
 
 int App::run() {
-    while (m_window.isOpen()) {
+    // The render thread takes over the window's GL context; events stay on this
+    // thread because SFML requires them on the thread that created the window.
+    m_window.setActive(false);
+    m_rendering = true;
+    std::thread renderThread(&App::renderLoop, this);
+
+    auto nextTick = std::chrono::steady_clock::now();
+    std::exception_ptr error;
+    while (m_running) {
+#if TD_PROFILER
+        Profiler::get().beginFrame();
+#endif
+        TD_TRACE_SCOPE("frame", "frame");
+        try {
+            pollStartup();
+        } catch (...) {
+            // Rethrown once the render thread has let go of the window.
+            error = std::current_exception();
+            m_running = false;
+            break;
+        }
         processEvents();
         float dt = m_time.tick();
+        const auto tickBegin = std::chrono::steady_clock::now();
         update(dt);
-        render();
+        const double tickMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tickBegin).count();
+        m_game->publish(m_snapshots.back());
+        m_snapshots.publish();
+#if TD_PROFILER
+        Profiler::get().endFrame();
+        {
+            std::lock_guard<std::mutex> lock(m_overlayMutex);
+            const GameState state = m_game->state();
+            const bool inLevel = state == GameState::Gameplay || state == GameState::Paused ||
+                                 state == GameState::Victory || state == GameState::Defeat;
+            m_profilerOverlay.update(Profiler::get(), inLevel ? &m_game->simulation().registry() : nullptr);
+        }
+#endif
+        if (m_hitches) m_hitches->endFrame(dt, tickMs, *m_game);
+
+        nextTick = std::max(nextTick + kTickInterval, std::chrono::steady_clock::now() - kTickInterval);
+        std::this_thread::sleep_until(nextTick);
     }
+
+    m_rendering = false;
+    renderThread.join();
+    m_window.setActive(true);
+    m_window.close();
+    Trace::get().stop();
+    if (error) std::rethrow_exception(error);
     return 0;
 }
 
@@ -83,22 +228,71 @@ void App::processEvents() {
     sf::Event event;
     while (m_window.pollEvent(event)) {
         if (event.type == sf::Event::Closed) {
-            m_window.close();
+            m_running = false;
+        }
+#if TD_PROFILER
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+            std::lock_guard<std::mutex> lock(m_overlayMutex);
+            m_profilerOverlay.toggle();
         }
-        sf::Vector2f mouseWorld = m_window.mapPixelToCoords(sf::Mouse::getPosition(m_window));
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F4) {
+            const std::string path = timestampedName("profile_", ".csv");
+            if (Profiler::get().dumpCsv(path)) {
+                std::cout << "[Profiler] Samples written to " << path << "\n";
+            }
+        }
+#endif
+        // The render thread changes the window's current view mid-frame; the default view never changes.
+        sf::Vector2f mouseWorld =
+            m_window.mapPixelToCoords(sf::Mouse::getPosition(m_window), m_window.getDefaultView());
+        if (m_hitches) m_hitches->recordInput(event, mouseWorld);
         m_game->handleEvent(event, mouseWorld);
     }
 }
 
 void App::update(float dt) {
+    TD_TRACE_SCOPE("frame", "App::update");
+    // Reparsed on the watcher thread; swapping the result in between ticks costs next to nothing.
+    if (m_hotReload && m_hotReload->pending()) {
+        m_game->editDatabase([this]() { return m_hotReload->apply(m_database); });
+    }
     m_game->update(dt);
 }
 
-void App::render() {
-    m_window.clear(sf::Color(20, 30, 30));
-    m_game->draw(m_window);
-    m_window.display();
+void App::renderLoop() {
+    Trace::get().setThreadName("render");
+    m_window.setActive(true);
+    while (m_rendering) {
+        TD_TRACE_SCOPE("frame", "App::render");
+        // This thread owns the GL context, so decoded images become textures here.
+        m_resources.uploadPending();
+        if (m_startupStage.load(std::memory_order_acquire) == StartupStage::Uploading) {
+            try {
+                m_resources.uploadAtlas();
+            } catch (...) {
+                m_startupError = std::current_exception();
+            }
+            m_startupStage.store(StartupStage::Finishing, std::memory_order_release);
+        }
+        const RenderSnapshot& snapshot = m_snapshots.latest();
+        m_window.clear(sf::Color(20, 30, 30));
+        m_game->draw(m_window, snapshot);
+#if TD_PROFILER
+        {
+            std::lock_guard<std::mutex> lock(m_overlayMutex);
+            m_profilerOverlay.draw(m_window);
+        }
+#endif
+        // Blocks for the frame limit, pacing this thread independently of the simulation.
+        m_window.display();
+        if (!m_menuShown) {
+            m_menuShown = true;
+            const double menuMs =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_startupBegin).count();
+            std::cerr << "[Startup] Main menu shown after " << menuMs << " ms\n";
+        }
+    }
+    m_window.setActive(false);
 }
 
 } // namespace core
-
@@ -1,12 +1,25 @@
 #pragma once
 
+#include "DataHotReload.hpp"
 #include "DataLoader.hpp"
 #include "Game.hpp"
+#include "HitchDetector.hpp"
+#include "JobSystem.hpp"
+#include "LevelCatalog.hpp"
+#include "RenderSnapshot.hpp"
 #include "ResourceManager.hpp"
+#include "TaskGraph.hpp"
+#include "ThumbnailCache.hpp"
 #include "TimeStep.hpp"
+#include "TripleBuffer.hpp"
+#include "../ui/ProfilerOverlay.hpp"
 #include <SFML/Graphics.hpp>
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 
 namespace core {
 
@@ -16,19 +29,50 @@ public:
     int run();
 
 private:
+    // Startup runs as a task graph on worker threads while the main menu is
+    // already up: Loading until every task is done, Uploading while the render
+    // thread creates the atlas pages, Finishing until the main thread hands the
+    // data to the game.
+    enum class StartupStage { Loading, Uploading, Finishing, Done };
+
+    void scheduleStartup();
+    void pollStartup();
+    void finishStartup();
     void processEvents();
     void update(float dt);
-    void render();
+    void renderLoop();
+
+    static constexpr std::chrono::microseconds kTickInterval{16667}; // simulation thread rate, 60 Hz
 
     sf::RenderWindow m_window;
     core::ResourceManager m_resources;
     core::DataLoader m_loader;
     data::GameDatabase m_database;
+    // Declared before m_game, which points into both.
+    std::unique_ptr<core::LevelCatalog> m_levels;
+    std::unique_ptr<core::ThumbnailCache> m_thumbnails;
     std::unique_ptr<core::Game> m_game;
+    std::unique_ptr<core::HitchDetector> m_hitches;
+    std::unique_ptr<core::DataHotReload> m_hotReload;
     core::TimeStep m_time;
+    TripleBuffer<RenderSnapshot> m_snapshots;
+    std::atomic<bool> m_running{true};
+    std::atomic<bool> m_rendering{false};
     std::filesystem::path m_projectRoot;
     std::filesystem::path m_dataPath;
     std::filesystem::path m_assetsPath;
+    std::chrono::steady_clock::time_point m_startupBegin;
+    std::atomic<StartupStage> m_startupStage{StartupStage::Loading};
+    bool m_menuShown = false; // render thread only
+    std::exception_ptr m_startupError; // written before m_startupStage moves on
+    std::unique_ptr<core::TaskGraph> m_startup;
+    // Declared after everything the startup tasks write to, so it is destroyed
+    // (finishing the tasks already queued) before any of it.
+    std::unique_ptr<core::JobSystem> m_startupJobs;
+#if TD_PROFILER
+    std::mutex m_overlayMutex; // updated on the simulation thread, drawn on the render thread
+    ui::ProfilerOverlay m_profilerOverlay;
+#endif
 };
 
 } // namespace core
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace core {
+
+// Bump allocator for objects that all die together. Memory comes from blocks
+// that double in size up to kMaxBlockSize; nothing is freed or destroyed until
+// the arena itself goes away, so only trivially destructible types belong here.
+class Arena {
+public:
+    static constexpr std::size_t kFirstBlockSize = 64 * 1024;
+    static constexpr std::size_t kMaxBlockSize = 16 * 1024 * 1024;
+
+    Arena() = default;
+    Arena(Arena&& other) noexcept { *this = std::move(other); }
+    Arena& operator=(Arena&& other) noexcept {
+        m_blocks = std::move(other.m_blocks);
+        m_cursor = std::exchange(other.m_cursor, nullptr);
+        m_left = std::exchange(other.m_left, 0);
+        m_used = std::exchange(other.m_used, 0);
+        m_nextBlockSize = std::exchange(other.m_nextBlockSize, kFirstBlockSize / 2);
+        return *this;
+    }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment) {
+        auto address = reinterpret_cast<std::uintptr_t>(m_cursor);
+        std::size_t padding = (alignment - address % alignment) % alignment;
+        if (!m_cursor || padding + size > m_left) {
+            grow(size + alignment);
+            address = reinterpret_cast<std::uintptr_t>(m_cursor);
+            padding = (alignment - address % alignment) % alignment;
+        }
+        std::byte* result = m_cursor + padding;
+        m_cursor = result + size;
+        m_left -= padding + size;
+        m_used += size;
+        return result;
+    }
+
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>);
+        if (count == 0) return nullptr;
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Bytes handed out, excluding alignment padding and unused block tails.
+    std::size_t used() const { return m_used; }
+
+private:
+    void grow(std::size_t minimum) {
+        m_nextBlockSize = std::min(kMaxBlockSize, m_nextBlockSize * 2);
+        const std::size_t size = std::max(minimum, m_nextBlockSize);
+        // Not make_unique, which would zero the whole block.
+        m_blocks.emplace_back(new std::byte[size]);
+        m_cursor = m_blocks.back().get();
+        m_left = size;
+    }
+
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+    std::byte* m_cursor = nullptr;
+    std::size_t m_left = 0;
+    std::size_t m_used = 0;
+    std::size_t m_nextBlockSize = kFirstBlockSize / 2;
+};
+
+} // namespace core
@@ -0,0 +1,87 @@
+#include "DataHotReload.hpp"
+
+#include "DataLoader.hpp"
+#include "Trace.hpp"
+#include <iostream>
+
+namespace core {
+
+namespace {
+
+// Entries added, removed or different in `after`.
+template <typename Map>
+std::size_t countChanges(const Map& before, const Map& after) {
+    std::size_t changed = 0;
+    for (const auto& [id, value] : after) {
+        auto it = before.find(id);
+        if (it == before.end() || !(it->second == value)) ++changed;
+    }
+    for (const auto& [id, value] : before) {
+        if (!after.count(id)) ++changed;
+    }
+    return changed;
+}
+
+// Replaces `current` when `reloaded` differs; reports how many entries did.
+template <typename Map>
+bool patch(const std::string& file, const char* what, Map& current, Map& reloaded) {
+    const std::size_t changed = countChanges(current, reloaded);
+    std::cerr << "[HotReload] " << file << ": " << changed << " of " << reloaded.size() << " " << what
+              << " changed\n";
+    if (changed == 0) return false;
+    current = std::move(reloaded);
+    return true;
+}
+
+} // namespace
+
+DataHotReload::DataHotReload(std::filesystem::path dataPath)
+    : m_dataPath(std::move(dataPath)), m_watcher(m_dataPath, [this](const std::string& file) { reload(file); }) {}
+
+void DataHotReload::reload(const std::string& file) {
+    TD_TRACE_SCOPE("data", "DataHotReload::reload", file);
+    Reloaded reloaded{file, {}};
+    try {
+        if (!DataLoader::loadFile(m_dataPath.string(), file, reloaded.data)) return;
+    } catch (const std::exception& e) {
+        std::cerr << "[HotReload] Keeping the loaded data, " << e.what() << "\n";
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // A file saved twice before apply() only needs its latest version.
+    std::erase_if(m_reloaded, [&](const Reloaded& older) { return older.file == file; });
+    m_reloaded.push_back(std::move(reloaded));
+    m_pending.store(true, std::memory_order_release);
+}
+
+bool DataHotReload::apply(data::GameDatabase& database) {
+    TD_TRACE_SCOPE("data", "DataHotReload::apply");
+    std::vector<Reloaded> reloaded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        reloaded.swap(m_reloaded);
+        m_pending.store(false, std::memory_order_release);
+    }
+    bool changed = false;
+    for (auto& [file, data] : reloaded) {
+        if (file == "towers.json") {
+            changed |= patch(file, "towers", database.towers, data.towers);
+        } else if (file == "enemies.json") {
+            changed |= patch(file, "enemies", database.enemies, data.enemies);
+        } else if (file == "waves.json") {
+            changed |= patch(file, "wave lists", database.waves, data.waves);
+        } else if (file == "balance.json") {
+            changed |= patch(file, "status definitions", database.balance.statuses, data.balance.statuses);
+            // Statuses are current now; whatever still differs is in the global, curve or economy values.
+            data.balance.statuses = database.balance.statuses;
+            if (!(data.balance == database.balance)) {
+                database.balance = std::move(data.balance);
+                std::cerr << "[HotReload] " << file << ": global, curve or economy values changed\n";
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+} // namespace core
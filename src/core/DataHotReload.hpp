@@ -0,0 +1,44 @@
+#pragma once
+
+#include "FileWatcher.hpp"
+#include "GameData.hpp"
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace core {
+
+// Watches the data directory while the game runs. When towers.json,
+// enemies.json, waves.json or balance.json is saved, the file is parsed again
+// on the watcher's thread; apply() then swaps the parts that changed into the
+// database in one step. A file that fails to parse is reported and ignored,
+// and the data loaded before stays in use.
+class DataHotReload {
+public:
+    explicit DataHotReload(std::filesystem::path dataPath);
+
+    // True once a reparsed file is waiting for apply().
+    bool pending() const { return m_pending.load(std::memory_order_acquire); }
+    // Moves every reparsed file into `database` and returns whether anything
+    // in it changed. Nothing may read the database during the call.
+    bool apply(data::GameDatabase& database);
+
+private:
+    struct Reloaded {
+        std::string file;
+        data::GameDatabase data; // only the part that `file` fills
+    };
+
+    void reload(const std::string& file);
+
+    std::filesystem::path m_dataPath;
+    std::mutex m_mutex; // guards m_reloaded
+    std::vector<Reloaded> m_reloaded;
+    std::atomic<bool> m_pending{false};
+    // Last member, so its thread is joined before the state it writes is destroyed.
+    FileWatcher m_watcher;
+};
+
+} // namespace core
@@ -1,27 +1,20 @@
 #include "DataLoader.hpp"
 
+#include "DataPack.hpp"
+#include "Json.hpp"
+#include "Trace.hpp"
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/Vector3.hpp>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <nlohmann/json.hpp>
 
 namespace core {
 
-using nlohmann::json;
-
 namespace {
 
-json loadJsonFile(const std::string& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open JSON file: " + path);
-    }
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    return json::parse(content);
-}
-
-std::vector<sf::Vector2i> parseVector2iArray(const json& arr) {
+std::vector<sf::Vector2i> parseVector2iArray(const JsonValue& arr) {
     std::vector<sf::Vector2i> out;
     for (const auto& value : arr) {
         if (value.is_array() && value.size() >= 2) {
@@ -31,7 +24,7 @@ std::vector<sf::Vector2i> parseVector2iArray(const json& arr) {
     return out;
 }
 
-std::vector<std::vector<int>> parsePaths(const json& pathArray) {
+std::vector<std::vector<int>> parsePaths(const JsonValue& pathArray) {
     std::vector<std::vector<int>> out;
     for (const auto& path : pathArray) {
         const auto& points = path.at("points");
@@ -45,7 +38,7 @@ std::vector<std::vector<int>> parsePaths(const json& pathArray) {
     return out;
 }
 
-void applyBranch(const json& branchJson, data::BranchModifier& branch) {
+void applyBranch(const JsonValue& branchJson, data::BranchModifier& branch) {
     if (branchJson.contains("name")) branch.name = branchJson.at("name").get<std::string>();
     if (branchJson.contains("description")) branch.description = branchJson.at("description").get<std::string>();
     if (branchJson.contains("damage")) branch.damage = branchJson.at("damage").get<float>();
@@ -64,13 +57,10 @@ void applyBranch(const json& branchJson, data::BranchModifier& branch) {
     if (branchJson.contains("canHitFlying")) branch.canHitFlying = branchJson.at("canHitFlying").get<bool>();
 }
 
-} // namespace
-
-data::GameDatabase DataLoader::loadAll(const std::string& dataPath) {
-    data::GameDatabase db;
-
-    // Towers
-    auto towersJson = loadJsonFile(dataPath + "/towers.json");
+void loadTowers(const std::string& dataPath, data::GameDatabase& db) {
+    TD_TRACE_SCOPE("data", "towers.json");
+    const JsonDocument towersDocument = JsonDocument::parseFile(dataPath + "/towers.json");
+    const JsonValue& towersJson = towersDocument.root();
     for (const auto& tower : towersJson.at("towers")) {
         data::TowerDefinition def;
         def.id = tower.at("id").get<std::string>();
@@ -117,9 +107,12 @@ data::GameDatabase DataLoader::loadAll(const std::string& dataPath) {
         if (tower.contains("branchB")) applyBranch(tower.at("branchB"), def.branchB);
         db.towers[def.id] = def;
     }
+}
 
-    // Enemies
-    auto enemiesJson = loadJsonFile(dataPath + "/enemies.json");
+void loadEnemies(const std::string& dataPath, data::GameDatabase& db) {
+    TD_TRACE_SCOPE("data", "enemies.json");
+    const JsonDocument enemiesDocument = JsonDocument::parseFile(dataPath + "/enemies.json");
+    const JsonValue& enemiesJson = enemiesDocument.root();
     for (const auto& enemy : enemiesJson.at("enemies")) {
         data::EnemyDefinition def;
         def.id = enemy.at("id").get<std::string>();
@@ -137,11 +130,14 @@ data::GameDatabase DataLoader::loadAll(const std::string& dataPath) {
         }
         db.enemies[def.id] = def;
     }
+}
 
-    // Waves
-    auto wavesJson = loadJsonFile(dataPath + "/waves.json");
+void loadWaves(const std::string& dataPath, data::GameDatabase& db) {
+    TD_TRACE_SCOPE("data", "waves.json");
+    const JsonDocument wavesDocument = JsonDocument::parseFile(dataPath + "/waves.json");
+    const JsonValue& wavesJson = wavesDocument.root();
     const auto& levels = wavesJson.at("levels");
-    for (const auto& [levelId, value] : levels.get<nlohmann::json::object_t>()) {
+    for (const auto& [levelId, value] : levels.members()) {
         data::LevelWaves lw;
         for (const auto& wave : value.at("waves")) {
             data::WaveDefinition def;
@@ -156,35 +152,22 @@ data::GameDatabase DataLoader::loadAll(const std::string& dataPath) {
             }
             lw.waves.push_back(def);
         }
-        db.waves[levelId] = lw;
+        db.waves[std::string(levelId)] = lw;
     }
+}
 
-    // Levels
-    for (int i = 1; i <= 12; ++i) {
-        const std::string levelId = (i < 10 ? "level_0" : "level_") + std::to_string(i);
-        auto path = dataPath + "/levels/" + levelId + ".json";
-        auto levelJson = loadJsonFile(path);
-        data::LevelDefinition def;
-        def.id = levelJson.at("id").get<std::string>();
-        def.name = levelJson.at("name").get<std::string>();
-        def.biome = levelJson.at("biome").get<std::string>();
-        def.width = static_cast<int>(levelJson.at("grid").at("width").get<float>());
-        def.height = static_cast<int>(levelJson.at("grid").at("height").get<float>());
-        def.tileSize = static_cast<int>(levelJson.at("grid").at("tileSize").get<float>());
-        def.paths = parsePaths(levelJson.at("paths"));
-        def.buildable = parseVector2iArray(levelJson.at("buildable"));
-        def.obstacles = parseVector2iArray(levelJson.at("obstacles"));
-        for (const auto& rule : levelJson.at("rules")) {
-            def.rules.push_back(rule.get<std::string>());
-        }
-        def.wavesId = levelJson.at("waves").get<std::string>();
-        def.startCoins = static_cast<int>(levelJson.at("startCoins").get<float>());
-        def.startLives = static_cast<int>(levelJson.at("startLives").get<float>());
-        db.levels[def.id] = def;
+void loadLevels(const std::string& dataPath, data::GameDatabase& db) {
+    TD_TRACE_SCOPE("data", "levels");
+    for (const auto& file : DataLoader::findLevelFiles(dataPath + "/levels")) {
+        data::LevelDefinition def = DataLoader::loadLevel(file);
+        db.levels[def.id] = std::move(def);
     }
+}
 
-    // Balance
-    auto balanceJson = loadJsonFile(dataPath + "/balance.json");
+void loadBalance(const std::string& dataPath, data::GameDatabase& db) {
+    TD_TRACE_SCOPE("data", "balance.json");
+    const JsonDocument balanceDocument = JsonDocument::parseFile(dataPath + "/balance.json");
+    const JsonValue& balanceJson = balanceDocument.root();
     db.balance.baseLives = static_cast<int>(balanceJson.at("global").at("baseLives").get<float>());
     db.balance.baseCoins = static_cast<int>(balanceJson.at("global").at("baseCoins").get<float>());
     db.balance.enemyHpMultiplier = balanceJson.at("global").at("enemyHpMultiplier").get<float>();
@@ -199,7 +182,7 @@ data::GameDatabase DataLoader::loadAll(const std::string& dataPath) {
         db.balance.difficultyCurve[level] = sf::Vector3f{hp, speed, reward};
     }
 
-    for (const auto& [statusId, statusJson] : balanceJson.at("status").get<nlohmann::json::object_t>()) {
+    for (const auto& [statusId, statusJson] : balanceJson.at("status").members()) {
         data::StatusDefinition def;
         if (statusJson.contains("multiplier")) def.multiplier = statusJson.at("multiplier").get<float>();
         if (statusJson.contains("duration")) def.duration = statusJson.at("duration").get<float>();
@@ -208,23 +191,31 @@ data::GameDatabase DataLoader::loadAll(const std::string& dataPath) {
         if (statusJson.contains("stun")) def.stun = statusJson.at("stun").get<float>();
         if (statusJson.contains("armor")) def.armor = statusJson.at("armor").get<float>();
         if (statusJson.contains("magicResist")) def.magicResist = statusJson.at("magicResist").get<float>();
-        db.balance.statuses[statusId] = def;
+        db.balance.statuses[std::string(statusId)] = def;
     }
 
     db.balance.killRewardBonus = balanceJson.at("economy").at("killRewardBonus").get<float>();
     db.balance.waveClearBonus = balanceJson.at("economy").at("waveClearBonus").get<float>();
     db.balance.sellRefund = balanceJson.at("economy").at("sellRefund").get<float>();
+}
 
-    // Settings
-    auto settingsJson = loadJsonFile(dataPath + "/settings.json");
+void loadSettings(const std::string& dataPath, data::GameDatabase& db) {
+    TD_TRACE_SCOPE("data", "settings.json");
+    const JsonDocument settingsDocument = JsonDocument::parseFile(dataPath + "/settings.json");
+    const JsonValue& settingsJson = settingsDocument.root();
     db.settings.audioVolume = settingsJson.value("audioVolume", 1.f);
     db.settings.musicVolume = settingsJson.value("musicVolume", 1.f);
     db.settings.gameSpeed = static_cast<int>(settingsJson.value("gameSpeed", 1));
     db.settings.graphicsQuality = settingsJson.value("graphicsQuality", std::string("medium"));
     db.settings.colorBlindMode = settingsJson.value("colorBlindMode", std::string("normal"));
+    db.settings.hitchBudgetMs = settingsJson.value("hitchBudgetMs", 50.f);
+    db.settings.hitchHistoryFrames = settingsJson.value("hitchHistoryFrames", 120);
+}
 
-    // Save
-    auto saveJson = loadJsonFile(dataPath + "/save.json");
+void loadSave(const std::string& dataPath, data::GameDatabase& db) {
+    TD_TRACE_SCOPE("data", "save.json");
+    const JsonDocument saveDocument = JsonDocument::parseFile(dataPath + "/save.json");
+    const JsonValue& saveJson = saveDocument.root();
     db.save.lastUnlockedLevel = static_cast<int>(saveJson.value("lastUnlockedLevel", 1));
     db.save.coins = static_cast<int>(saveJson.value("coins", 0));
     if (saveJson.contains("badges")) {
@@ -242,16 +233,141 @@ data::GameDatabase DataLoader::loadAll(const std::string& dataPath) {
             db.save.completedLevels.push_back(lvl.get<std::string>());
         }
     }
+}
+
+// Everything the data pack holds, i.e. all but settings and save.
+void loadStaticData(const std::string& dataPath, data::GameDatabase& db, bool withLevels) {
+    loadTowers(dataPath, db);
+    loadEnemies(dataPath, db);
+    loadWaves(dataPath, db);
+    if (withLevels) loadLevels(dataPath, db);
+    loadBalance(dataPath, db);
+}
+
+} // namespace
+
+std::vector<std::filesystem::path> DataLoader::findLevelFiles(const std::filesystem::path& directory) {
+    std::vector<std::filesystem::path> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.path().extension() == ".json") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+data::LevelDefinition DataLoader::loadLevel(const std::filesystem::path& file) {
+    TD_TRACE_SCOPE("data", "level", file.stem().string());
+    const JsonDocument levelDocument = JsonDocument::parseFile(file);
+    const JsonValue& levelJson = levelDocument.root();
+    data::LevelDefinition def;
+    def.id = levelJson.at("id").get<std::string>();
+    def.name = levelJson.at("name").get<std::string>();
+    def.biome = levelJson.at("biome").get<std::string>();
+    def.width = static_cast<int>(levelJson.at("grid").at("width").get<float>());
+    def.height = static_cast<int>(levelJson.at("grid").at("height").get<float>());
+    def.tileSize = static_cast<int>(levelJson.at("grid").at("tileSize").get<float>());
+    def.paths = parsePaths(levelJson.at("paths"));
+    def.buildable = parseVector2iArray(levelJson.at("buildable"));
+    def.obstacles = parseVector2iArray(levelJson.at("obstacles"));
+    for (const auto& rule : levelJson.at("rules")) {
+        def.rules.push_back(rule.get<std::string>());
+    }
+    def.wavesId = levelJson.at("waves").get<std::string>();
+    def.startCoins = static_cast<int>(levelJson.at("startCoins").get<float>());
+    def.startLives = static_cast<int>(levelJson.at("startLives").get<float>());
+    return def;
+}
+
+bool DataLoader::loadFile(const std::string& dataPath, const std::string& fileName, data::GameDatabase& out) {
+    if (fileName == "towers.json") loadTowers(dataPath, out);
+    else if (fileName == "enemies.json") loadEnemies(dataPath, out);
+    else if (fileName == "waves.json") loadWaves(dataPath, out);
+    else if (fileName == "balance.json") loadBalance(dataPath, out);
+    else return false;
+    return true;
+}
+
+data::GameDatabase DataLoader::loadAll(const std::string& dataPath) {
+    TD_TRACE_SCOPE("data", "DataLoader::loadAll");
+    if (m_packPath.empty()) return loadJson(dataPath);
+    data::GameDatabase db;
+    if (dataPackIsFresh(m_packPath, dataPath, m_loadLevels) && readDataPack(m_packPath, db)) {
+        if (!m_loadLevels) db.levels.clear();
+        loadSettings(dataPath, db);
+        loadSave(dataPath, db);
+        return db;
+    }
+    db = loadJson(dataPath);
+    writeDataPack(db, m_packPath);
+    return db;
+}
 
+data::GameDatabase DataLoader::loadJson(const std::string& dataPath) {
+    TD_TRACE_SCOPE("data", "DataLoader::loadJson");
+    data::GameDatabase db;
+    loadStaticData(dataPath, db, m_loadLevels);
+    loadSettings(dataPath, db);
+    loadSave(dataPath, db);
     return db;
 }
 
+TaskGraph::TaskId DataLoader::schedule(TaskGraph& graph, const std::string& dataPath, data::GameDatabase& out) {
+    // Every task writes a different member of `out`, so none of them need a lock.
+    std::vector<TaskGraph::TaskId> parts;
+    parts.push_back(graph.add("settings.json", [dataPath, &out]() { loadSettings(dataPath, out); }));
+    parts.push_back(graph.add("save.json", [dataPath, &out]() { loadSave(dataPath, out); }));
+    const std::filesystem::path packPath = m_packPath;
+    if (!packPath.empty() && dataPackIsFresh(packPath, dataPath, m_loadLevels)) {
+        const bool withLevels = m_loadLevels;
+        parts.push_back(graph.add("data pack", [dataPath, packPath, withLevels, &out]() {
+            if (readDataPack(packPath, out)) {
+                if (!withLevels) out.levels.clear();
+                return;
+            }
+            loadStaticData(dataPath, out, withLevels);
+            writeDataPack(out, packPath);
+        }));
+        return graph.add("game data", []() {}, parts);
+    }
+
+    std::vector<TaskGraph::TaskId> staticParts;
+    staticParts.push_back(graph.add("towers.json", [dataPath, &out]() { loadTowers(dataPath, out); }));
+    staticParts.push_back(graph.add("enemies.json", [dataPath, &out]() { loadEnemies(dataPath, out); }));
+    staticParts.push_back(graph.add("waves.json", [dataPath, &out]() { loadWaves(dataPath, out); }));
+    staticParts.push_back(graph.add("balance.json", [dataPath, &out]() { loadBalance(dataPath, out); }));
+    if (m_loadLevels) {
+        // Levels are parsed into their own slots and merged into the map by one task.
+        const std::vector<std::filesystem::path> levelFiles = findLevelFiles(dataPath + "/levels");
+        auto levels = std::make_shared<std::vector<data::LevelDefinition>>(levelFiles.size());
+        std::vector<TaskGraph::TaskId> levelParts;
+        for (std::size_t i = 0; i < levelFiles.size(); ++i) {
+            const std::filesystem::path file = levelFiles[i];
+            levelParts.push_back(graph.add(file.filename().string(), [file, levels, i]() {
+                (*levels)[i] = loadLevel(file);
+            }));
+        }
+        staticParts.push_back(graph.add("levels", [levels, &out]() {
+            for (auto& def : *levels) out.levels[def.id] = std::move(def);
+            levels->clear();
+        }, levelParts));
+    }
+    if (!packPath.empty()) {
+        staticParts.push_back(graph.add("cook data pack", [packPath, &out]() { writeDataPack(out, packPath); },
+                                        std::vector<TaskGraph::TaskId>(staticParts)));
+    }
+    parts.insert(parts.end(), staticParts.begin(), staticParts.end());
+    return graph.add("game data", []() {}, parts);
+}
+
 void DataLoader::saveSettings(const std::string& path, const data::SettingsData& settings) {
     const nlohmann::json j{{"audioVolume", settings.audioVolume},
                            {"musicVolume", settings.musicVolume},
                            {"gameSpeed", settings.gameSpeed},
                            {"graphicsQuality", settings.graphicsQuality},
-                           {"colorBlindMode", settings.colorBlindMode}};
+                           {"colorBlindMode", settings.colorBlindMode},
+                           {"hitchBudgetMs", settings.hitchBudgetMs},
+                           {"hitchHistoryFrames", settings.hitchHistoryFrames}};
 
     std::ofstream file(path);
     file << j.dump(2);
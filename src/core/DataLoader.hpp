@@ -1,15 +1,42 @@
 #pragma once
 
 #include "GameData.hpp"
+#include "TaskGraph.hpp"
+#include <filesystem>
 #include <string>
+#include <vector>
 
 namespace core {
 
 class DataLoader {
 public:
+    // With a pack path set, loadAll reads the static data from that cooked pack
+    // (see DataPack.hpp) while it is newer than the JSON, and re-cooks it after
+    // falling back to JSON.
+    void setPackPath(std::filesystem::path path) { m_packPath = std::move(path); }
+    // With levels off, db.levels stays empty and levels are left to a
+    // LevelCatalog. A pack cooked that way holds no levels either, so it needs
+    // a pack path of its own.
+    void setLoadLevels(bool load) { m_loadLevels = load; }
     data::GameDatabase loadAll(const std::string& dataPath);
+    // Always parses the JSON files, ignoring any pack.
+    data::GameDatabase loadJson(const std::string& dataPath);
+    // Adds what loadAll does to `graph` as independent tasks (one per file when
+    // parsing JSON) that fill `out` in place. Returns the task that finishes
+    // last; `out` must not be read before it is done.
+    TaskGraph::TaskId schedule(TaskGraph& graph, const std::string& dataPath, data::GameDatabase& out);
+    // The *.json files of a level directory, sorted by name.
+    static std::vector<std::filesystem::path> findLevelFiles(const std::filesystem::path& directory);
+    static data::LevelDefinition loadLevel(const std::filesystem::path& file);
+    // Parses one of towers.json, enemies.json, waves.json and balance.json into
+    // the matching part of `out`; false for any other file name.
+    static bool loadFile(const std::string& dataPath, const std::string& fileName, data::GameDatabase& out);
     void saveSettings(const std::string& path, const data::SettingsData& settings);
     void saveProgress(const std::string& path, const data::SaveData& save);
+
+private:
+    std::filesystem::path m_packPath;
+    bool m_loadLevels = true;
 };
 
 } // namespace core
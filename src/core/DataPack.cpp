@@ -0,0 +1,605 @@
+#include "DataPack.hpp"
+
+#include "Hash.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace core {
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x4b504454; // "TDPK" in a little-endian file
+constexpr std::size_t kSectionAlignment = 8;
+
+enum class Section : std::uint32_t {
+    Strings,    // UTF-8 bytes of every distinct string
+    StringRefs, // PackString lists: tags, abilities, rules
+    Towers,
+    Upgrades,
+    Enemies,
+    LevelWaves,
+    Waves,
+    Spawns,
+    Levels,
+    Paths, // PackRange per level path, into Ints
+    Ints,  // flattened path points
+    Cells,
+    Curve,
+    Statuses,
+    Balance,
+    Count
+};
+constexpr std::size_t kSectionCount = static_cast<std::size_t>(Section::Count);
+
+struct PackString {
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+struct PackRange {
+    std::uint32_t first;
+    std::uint32_t count;
+};
+
+struct PackBranch {
+    PackString name;
+    PackString description;
+    float damage, fireRate, range, armorPen, aoeRadius, chain, pierce, critChance, critMultiplier;
+    float statusPotency, statusDuration, income, magicResistShred;
+    std::uint32_t canHitFlying;
+};
+
+struct PackTower {
+    PackString id, name, role, projectileType, statusEffect;
+    std::int32_t cost;
+    float damage, fireRate, range, aoeRadius, armorPen, projectileSpeed, chain, pierce;
+    float statusPotency, statusDuration, income;
+    std::uint32_t canHitFlying;
+    PackRange tags;     // StringRefs
+    PackRange upgrades; // Upgrades
+    PackBranch branchA, branchB;
+};
+
+struct PackEnemy {
+    PackString id, name;
+    float hp, speed, armor, magicResist;
+    std::int32_t reward;
+    PackRange abilities, tags; // StringRefs
+};
+
+struct PackLevelWaves {
+    PackString levelId;
+    PackRange waves;
+};
+
+struct PackWave {
+    std::int32_t id;
+    float spawnInterval;
+    PackRange spawns;
+};
+
+struct PackSpawn {
+    PackString type;
+    std::int32_t count;
+    float delay;
+};
+
+struct PackCell {
+    std::int32_t x, y;
+};
+
+struct PackLevel {
+    PackString id, name, biome, wavesId;
+    std::int32_t width, height, tileSize, startCoins, startLives;
+    PackRange paths;                // Paths
+    PackRange buildable, obstacles; // Cells
+    PackRange rules;                // StringRefs
+};
+
+struct PackCurvePoint {
+    std::int32_t level;
+    float hp, speed, reward;
+};
+
+struct PackStatus {
+    PackString id;
+    data::StatusDefinition definition;
+};
+
+struct PackBalance {
+    std::int32_t baseLives, baseCoins;
+    float enemyHpMultiplier, enemySpeedMultiplier, enemyRewardMultiplier;
+    float killRewardBonus, waveClearBonus, sellRefund;
+    PackRange curve, statuses;
+};
+
+struct PackSection {
+    std::uint64_t offset;
+    std::uint64_t size; // bytes
+};
+
+struct PackHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t fileSize;
+    std::array<PackSection, kSectionCount> sections;
+};
+
+static_assert(std::is_trivially_copyable_v<data::UpgradeModifier>);
+static_assert(std::is_trivially_copyable_v<data::StatusDefinition>);
+static_assert(std::is_trivially_copyable_v<PackTower> && std::is_trivially_copyable_v<PackLevel>);
+
+template <typename T>
+std::uint32_t narrow(T value) {
+    if (value > static_cast<T>(UINT32_MAX)) throw std::runtime_error("Data pack table too large");
+    return static_cast<std::uint32_t>(value);
+}
+
+// Collects records into per-section tables while interning strings.
+class PackBuilder {
+public:
+    PackString intern(const std::string& text) {
+        auto [it, inserted] = m_interned.try_emplace(text, PackString{});
+        if (inserted) {
+            it->second = {narrow(m_strings.size()), narrow(text.size())};
+            m_strings.insert(m_strings.end(), text.begin(), text.end());
+        }
+        return it->second;
+    }
+
+    PackRange strings(const std::vector<std::string>& list) {
+        const PackRange range{narrow(m_stringRefs.size()), narrow(list.size())};
+        for (const auto& text : list) m_stringRefs.push_back(intern(text));
+        return range;
+    }
+
+    PackRange cells(const std::vector<sf::Vector2i>& list) {
+        const PackRange range{narrow(m_cells.size()), narrow(list.size())};
+        for (const auto& cell : list) m_cells.push_back({cell.x, cell.y});
+        return range;
+    }
+
+    PackBranch branch(const data::BranchModifier& b) {
+        return {intern(b.name), intern(b.description), b.damage, b.fireRate, b.range, b.armorPen, b.aoeRadius,
+                b.chain, b.pierce, b.critChance, b.critMultiplier, b.statusPotency, b.statusDuration, b.income,
+                b.magicResistShred, b.canHitFlying ? 1u : 0u};
+    }
+
+    void tower(const data::TowerDefinition& t) {
+        const PackRange upgrades{narrow(m_upgrades.size()), narrow(t.upgrades.size())};
+        m_upgrades.insert(m_upgrades.end(), t.upgrades.begin(), t.upgrades.end());
+        m_towers.push_back({intern(t.id), intern(t.name), intern(t.role), intern(t.projectileType),
+                            intern(t.statusEffect), t.cost, t.damage, t.fireRate, t.range, t.aoeRadius, t.armorPen,
+                            t.projectileSpeed, t.chain, t.pierce, t.statusPotency, t.statusDuration, t.income,
+                            t.canHitFlying ? 1u : 0u, strings(t.tags), upgrades, branch(t.branchA), branch(t.branchB)});
+    }
+
+    void enemy(const data::EnemyDefinition& e) {
+        m_enemies.push_back({intern(e.id), intern(e.name), e.hp, e.speed, e.armor, e.magicResist, e.reward,
+                             strings(e.abilities), strings(e.tags)});
+    }
+
+    void levelWaves(const std::string& levelId, const data::LevelWaves& lw) {
+        const PackRange waves{narrow(m_waves.size()), narrow(lw.waves.size())};
+        for (const auto& wave : lw.waves) {
+            const PackRange spawns{narrow(m_spawns.size()), narrow(wave.enemies.size())};
+            for (const auto& spawn : wave.enemies) m_spawns.push_back({intern(spawn.type), spawn.count, spawn.delay});
+            m_waves.push_back({wave.id, wave.spawnInterval, spawns});
+        }
+        m_levelWaves.push_back({intern(levelId), waves});
+    }
+
+    void level(const data::LevelDefinition& l) {
+        const PackRange paths{narrow(m_paths.size()), narrow(l.paths.size())};
+        for (const auto& path : l.paths) {
+            m_paths.push_back({narrow(m_ints.size()), narrow(path.size())});
+            m_ints.insert(m_ints.end(), path.begin(), path.end());
+        }
+        m_levels.push_back({intern(l.id), intern(l.name), intern(l.biome), intern(l.wavesId), l.width, l.height,
+                            l.tileSize, l.startCoins, l.startLives, paths, cells(l.buildable), cells(l.obstacles),
+                            strings(l.rules)});
+    }
+
+    void balance(const data::BalanceDefinition& b) {
+        const std::map<int, sf::Vector3f> curve(b.difficultyCurve.begin(), b.difficultyCurve.end());
+        const std::map<std::string, data::StatusDefinition> statuses(b.statuses.begin(), b.statuses.end());
+        const PackRange curveRange{narrow(m_curve.size()), narrow(curve.size())};
+        for (const auto& [level, point] : curve) m_curve.push_back({level, point.x, point.y, point.z});
+        const PackRange statusRange{narrow(m_statuses.size()), narrow(statuses.size())};
+        for (const auto& [id, definition] : statuses) m_statuses.push_back({intern(id), definition});
+        m_balance.push_back({b.baseLives, b.baseCoins, b.enemyHpMultiplier, b.enemySpeedMultiplier,
+                             b.enemyRewardMultiplier, b.killRewardBonus, b.waveClearBonus, b.sellRefund, curveRange,
+                             statusRange});
+    }
+
+    std::vector<char> finish() const {
+        PackHeader header{};
+        header.magic = kMagic;
+        header.version = kDataPackVersion;
+        std::vector<char> bytes(sizeof(PackHeader));
+        auto place = [&](Section section, const void* data, std::size_t size) {
+            bytes.resize((bytes.size() + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment);
+            header.sections[static_cast<std::size_t>(section)] = {bytes.size(), size};
+            const auto* begin = static_cast<const char*>(data);
+            bytes.insert(bytes.end(), begin, begin + size);
+        };
+        auto table = [&](Section section, const auto& records) {
+            place(section, records.data(), records.size() * sizeof(records[0]));
+        };
+        place(Section::Strings, m_strings.data(), m_strings.size());
+        table(Section::StringRefs, m_stringRefs);
+        table(Section::Towers, m_towers);
+        table(Section::Upgrades, m_upgrades);
+        table(Section::Enemies, m_enemies);
+        table(Section::LevelWaves, m_levelWaves);
+        table(Section::Waves, m_waves);
+        table(Section::Spawns, m_spawns);
+        table(Section::Levels, m_levels);
+        table(Section::Paths, m_paths);
+        table(Section::Ints, m_ints);
+        table(Section::Cells, m_cells);
+        table(Section::Curve, m_curve);
+        table(Section::Statuses, m_statuses);
+        table(Section::Balance, m_balance);
+        header.fileSize = bytes.size();
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        return bytes;
+    }
+
+private:
+    std::vector<char> m_strings;
+    std::unordered_map<std::string, PackString> m_interned;
+    std::vector<PackString> m_stringRefs;
+    std::vector<PackTower> m_towers;
+    std::vector<data::UpgradeModifier> m_upgrades;
+    std::vector<PackEnemy> m_enemies;
+    std::vector<PackLevelWaves> m_levelWaves;
+    std::vector<PackWave> m_waves;
+    std::vector<PackSpawn> m_spawns;
+    std::vector<PackLevel> m_levels;
+    std::vector<PackRange> m_paths;
+    std::vector<std::int32_t> m_ints;
+    std::vector<PackCell> m_cells;
+    std::vector<PackCurvePoint> m_curve;
+    std::vector<PackStatus> m_statuses;
+    std::vector<PackBalance> m_balance;
+};
+
+template <typename T>
+std::map<std::string, const T*> sortedById(const std::unordered_map<std::string, T>& table) {
+    std::map<std::string, const T*> out;
+    for (const auto& [id, value] : table) out.emplace(id, &value);
+    return out;
+}
+
+// Read-only view of a whole file: memory mapped where available, read into
+// memory otherwise.
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path) {
+#if defined(_WIN32)
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return;
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info {};
+        if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapped = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                m_data = static_cast<const char*>(mapped);
+                m_size = static_cast<std::size_t>(info.st_size);
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#if !defined(_WIN32)
+        if (m_data) ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+#if defined(_WIN32)
+    std::vector<char> m_buffer;
+#endif
+};
+
+// Typed, bounds-checked access to the tables of a mapped pack. Every failed
+// check throws, so a truncated or corrupt pack is rejected as a whole.
+class PackReader {
+public:
+    PackReader(const char* data, std::size_t size) : m_data(data) {
+        if (size < sizeof(PackHeader)) throw std::runtime_error("truncated header");
+        std::memcpy(&m_header, data, sizeof(PackHeader));
+        if (m_header.magic != kMagic) throw std::runtime_error("not a data pack");
+        if (m_header.version != kDataPackVersion) throw std::runtime_error("version mismatch");
+        if (m_header.fileSize != size) throw std::runtime_error("size mismatch");
+        for (const auto& section : m_header.sections) {
+            if (section.offset > size || section.size > size - section.offset) {
+                throw std::runtime_error("section out of bounds");
+            }
+        }
+    }
+
+    template <typename T>
+    std::span<const T> table(Section which) const {
+        const PackSection& section = m_header.sections[static_cast<std::size_t>(which)];
+        if (section.offset % alignof(T) != 0 || section.size % sizeof(T) != 0) {
+            throw std::runtime_error("misaligned section");
+        }
+        return {reinterpret_cast<const T*>(m_data + section.offset), static_cast<std::size_t>(section.size / sizeof(T))};
+    }
+
+    template <typename T>
+    std::span<const T> slice(std::span<const T> table, const PackRange& range) const {
+        if (range.first > table.size() || range.count > table.size() - range.first) {
+            throw std::runtime_error("range out of bounds");
+        }
+        return table.subspan(range.first, range.count);
+    }
+
+    std::string string(const PackString& ref) const {
+        const std::span<const char> strings = table<char>(Section::Strings);
+        if (ref.offset > strings.size() || ref.size > strings.size() - ref.offset) {
+            throw std::runtime_error("string out of bounds");
+        }
+        return std::string(strings.data() + ref.offset, ref.size);
+    }
+
+    std::vector<std::string> strings(const PackRange& range) const {
+        std::vector<std::string> out;
+        for (const auto& ref : slice(table<PackString>(Section::StringRefs), range)) out.push_back(string(ref));
+        return out;
+    }
+
+    std::vector<sf::Vector2i> cells(const PackRange& range) const {
+        std::vector<sf::Vector2i> out;
+        for (const auto& cell : slice(table<PackCell>(Section::Cells), range)) out.emplace_back(cell.x, cell.y);
+        return out;
+    }
+
+    data::BranchModifier branch(const PackBranch& b) const {
+        data::BranchModifier out;
+        out.name = string(b.name);
+        out.description = string(b.description);
+        out.damage = b.damage;
+        out.fireRate = b.fireRate;
+        out.range = b.range;
+        out.armorPen = b.armorPen;
+        out.aoeRadius = b.aoeRadius;
+        out.chain = b.chain;
+        out.pierce = b.pierce;
+        out.critChance = b.critChance;
+        out.critMultiplier = b.critMultiplier;
+        out.statusPotency = b.statusPotency;
+        out.statusDuration = b.statusDuration;
+        out.income = b.income;
+        out.magicResistShred = b.magicResistShred;
+        out.canHitFlying = b.canHitFlying != 0;
+        return out;
+    }
+
+private:
+    const char* m_data;
+    PackHeader m_header{};
+};
+
+void readTables(const PackReader& pack, data::GameDatabase& db) {
+    for (const auto& t : pack.table<PackTower>(Section::Towers)) {
+        data::TowerDefinition def;
+        def.id = pack.string(t.id);
+        def.name = pack.string(t.name);
+        def.role = pack.string(t.role);
+        def.projectileType = pack.string(t.projectileType);
+        def.statusEffect = pack.string(t.statusEffect);
+        def.cost = t.cost;
+        def.damage = t.damage;
+        def.fireRate = t.fireRate;
+        def.range = t.range;
+        def.aoeRadius = t.aoeRadius;
+        def.armorPen = t.armorPen;
+        def.projectileSpeed = t.projectileSpeed;
+        def.chain = t.chain;
+        def.pierce = t.pierce;
+        def.statusPotency = t.statusPotency;
+        def.statusDuration = t.statusDuration;
+        def.income = t.income;
+        def.canHitFlying = t.canHitFlying != 0;
+        def.tags = pack.strings(t.tags);
+        const auto upgrades = pack.slice(pack.table<data::UpgradeModifier>(Section::Upgrades), t.upgrades);
+        def.upgrades.assign(upgrades.begin(), upgrades.end());
+        def.branchA = pack.branch(t.branchA);
+        def.branchB = pack.branch(t.branchB);
+        db.towers[def.id] = std::move(def);
+    }
+
+    for (const auto& e : pack.table<PackEnemy>(Section::Enemies)) {
+        data::EnemyDefinition def;
+        def.id = pack.string(e.id);
+        def.name = pack.string(e.name);
+        def.hp = e.hp;
+        def.speed = e.speed;
+        def.armor = e.armor;
+        def.magicResist = e.magicResist;
+        def.reward = e.reward;
+        def.abilities = pack.strings(e.abilities);
+        def.tags = pack.strings(e.tags);
+        db.enemies[def.id] = std::move(def);
+    }
+
+    const auto waves = pack.table<PackWave>(Section::Waves);
+    const auto spawns = pack.table<PackSpawn>(Section::Spawns);
+    for (const auto& lw : pack.table<PackLevelWaves>(Section::LevelWaves)) {
+        data::LevelWaves out;
+        for (const auto& w : pack.slice(waves, lw.waves)) {
+            data::WaveDefinition def;
+            def.id = w.id;
+            def.spawnInterval = w.spawnInterval;
+            for (const auto& s : pack.slice(spawns, w.spawns)) def.enemies.push_back({pack.string(s.type), s.count, s.delay});
+            out.waves.push_back(std::move(def));
+        }
+        db.waves[pack.string(lw.levelId)] = std::move(out);
+    }
+
+    const auto paths = pack.table<PackRange>(Section::Paths);
+    const auto ints = pack.table<std::int32_t>(Section::Ints);
+    for (const auto& l : pack.table<PackLevel>(Section::Levels)) {
+        data::LevelDefinition def;
+        def.id = pack.string(l.id);
+        def.name = pack.string(l.name);
+        def.biome = pack.string(l.biome);
+        def.wavesId = pack.string(l.wavesId);
+        def.width = l.width;
+        def.height = l.height;
+        def.tileSize = l.tileSize;
+        def.startCoins = l.startCoins;
+        def.startLives = l.startLives;
+        for (const auto& path : pack.slice(paths, l.paths)) {
+            const auto points = pack.slice(ints, path);
+            def.paths.emplace_back(points.begin(), points.end());
+        }
+        def.buildable = pack.cells(l.buildable);
+        def.obstacles = pack.cells(l.obstacles);
+        def.rules = pack.strings(l.rules);
+        db.levels[def.id] = std::move(def);
+    }
+
+    const auto balance = pack.table<PackBalance>(Section::Balance);
+    if (balance.size() != 1) throw std::runtime_error("missing balance record");
+    const PackBalance& b = balance.front();
+    db.balance.baseLives = b.baseLives;
+    db.balance.baseCoins = b.baseCoins;
+    db.balance.enemyHpMultiplier = b.enemyHpMultiplier;
+    db.balance.enemySpeedMultiplier = b.enemySpeedMultiplier;
+    db.balance.enemyRewardMultiplier = b.enemyRewardMultiplier;
+    db.balance.killRewardBonus = b.killRewardBonus;
+    db.balance.waveClearBonus = b.waveClearBonus;
+    db.balance.sellRefund = b.sellRefund;
+    for (const auto& point : pack.slice(pack.table<PackCurvePoint>(Section::Curve), b.curve)) {
+        db.balance.difficultyCurve[point.level] = sf::Vector3f{point.hp, point.speed, point.reward};
+    }
+    for (const auto& status : pack.slice(pack.table<PackStatus>(Section::Statuses), b.statuses)) {
+        db.balance.statuses[pack.string(status.id)] = status.definition;
+    }
+}
+
+} // namespace
+
+bool writeDataPack(const data::GameDatabase& database, const std::filesystem::path& path) {
+    TD_TRACE_SCOPE("data", "writeDataPack");
+    std::vector<char> bytes;
+    try {
+        PackBuilder builder;
+        // Tables are written in id order so that identical data cooks to identical bytes.
+        for (const auto& [id, tower] : sortedById(database.towers)) builder.tower(*tower);
+        for (const auto& [id, enemy] : sortedById(database.enemies)) builder.enemy(*enemy);
+        for (const auto& [id, lw] : sortedById(database.waves)) builder.levelWaves(id, *lw);
+        for (const auto& [id, level] : sortedById(database.levels)) builder.level(*level);
+        builder.balance(database.balance);
+        bytes = builder.finish();
+    } catch (const std::exception& e) {
+        std::cerr << "[DataPack] Failed to cook " << path << ": " << e.what() << "\n";
+        return false;
+    }
+
+    std::error_code ec;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+    // Written beside the target and renamed over it, so a reader never maps a half-written pack.
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            std::cerr << "[DataPack] Failed to write " << temporary << "\n";
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary, path, ec);
+    if (ec) {
+        std::cerr << "[DataPack] Failed to replace " << path << ": " << ec.message() << "\n";
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+bool readDataPack(const std::filesystem::path& path, data::GameDatabase& database) {
+    TD_TRACE_SCOPE("data", "readDataPack");
+    const MappedFile file(path);
+    if (!file.data()) return false;
+    data::GameDatabase loaded;
+    try {
+        readTables(PackReader(file.data(), file.size()), loaded);
+    } catch (const std::exception& e) {
+        std::cerr << "[DataPack] Ignoring " << path << ": " << e.what() << "\n";
+        return false;
+    }
+    database.towers = std::move(loaded.towers);
+    database.enemies = std::move(loaded.enemies);
+    database.waves = std::move(loaded.waves);
+    database.levels = std::move(loaded.levels);
+    database.balance = std::move(loaded.balance);
+    return true;
+}
+
+std::filesystem::path dataPackPath(const std::filesystem::path& projectRoot, const std::filesystem::path& dataPath) {
+    // Normalized, so "data", "./data" and "data/" name the same pack.
+    std::error_code ec;
+    std::filesystem::path key = std::filesystem::weakly_canonical(std::filesystem::absolute(dataPath), ec);
+    if (ec) key = std::filesystem::absolute(dataPath).lexically_normal();
+    return projectRoot / "cache" / ("data_" + hashToHex(fnv1a(key.string())) + ".tdpack");
+}
+
+bool dataPackIsFresh(const std::filesystem::path& pack, const std::filesystem::path& dataPath, bool withLevels) {
+    std::error_code ec;
+    const auto packTime = std::filesystem::last_write_time(pack, ec);
+    if (ec) return false;
+    auto olderThanPack = [&](const std::filesystem::path& source) {
+        std::error_code sourceError;
+        const auto sourceTime = std::filesystem::last_write_time(source, sourceError);
+        return !sourceError && sourceTime <= packTime;
+    };
+    for (const char* name : {"towers.json", "enemies.json", "waves.json", "balance.json"}) {
+        if (!olderThanPack(dataPath / name)) return false;
+    }
+    if (!withLevels) return true;
+    for (const auto& entry : std::filesystem::directory_iterator(dataPath / "levels", ec)) {
+        if (entry.path().extension() == ".json" && !olderThanPack(entry.path())) return false;
+    }
+    return !ec;
+}
+
+} // namespace core
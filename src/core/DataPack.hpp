@@ -0,0 +1,39 @@
+#pragma once
+
+#include "GameData.hpp"
+#include <cstdint>
+#include <filesystem>
+
+namespace core {
+
+// Cooked binary form of the static game data: towers, enemies, waves, levels
+// and balance. Settings and save progress change at runtime and always come
+// from JSON.
+//
+// The file is a header followed by flat tables of fixed-size records. Records
+// refer to strings and to other tables by offset and count, and every string
+// is stored once in a shared string table, so reading is a memory map plus
+// bounds checks, with no text parsing.
+//
+// Packs are platform-local caches: they are written in host byte order and
+// record layout, and a pack from another version is simply ignored.
+constexpr std::uint32_t kDataPackVersion = 1;
+
+bool writeDataPack(const data::GameDatabase& database, const std::filesystem::path& path);
+
+// Fills the static tables of `database`. Returns false, leaving `database`
+// untouched, when the pack is missing, from another version or malformed.
+bool readDataPack(const std::filesystem::path& path, data::GameDatabase& database);
+
+// Where the pack cooked from `dataPath` lives under `projectRoot`: cache/
+// data_<hash of the data directory>.tdpack, so a TOWERDEFENSE_DATA override
+// never picks up another tree's pack. The game and towerdefense_cook both use it.
+std::filesystem::path dataPackPath(const std::filesystem::path& projectRoot, const std::filesystem::path& dataPath);
+
+// True when `pack` exists and is at least as new as every JSON file under
+// `dataPath` it is cooked from. The levels directory is only looked at when
+// `withLevels` is set; a caller that never reads levels from the pack does
+// not pay for listing it.
+bool dataPackIsFresh(const std::filesystem::path& pack, const std::filesystem::path& dataPath, bool withLevels);
+
+} // namespace core
@@ -0,0 +1,113 @@
+#include "FileWatcher.hpp"
+
+#include "Trace.hpp"
+#include <chrono>
+#include <iostream>
+#include <set>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <map>
+#endif
+
+namespace core {
+
+namespace {
+
+// How often the thread looks at m_stopping, and how long a burst of writes
+// must be quiet before it is reported.
+constexpr int kWakeIntervalMs = 100;
+constexpr auto kSettleTime = std::chrono::milliseconds(150);
+
+} // namespace
+
+FileWatcher::FileWatcher(std::filesystem::path directory, Callback onChange)
+    : m_directory(std::move(directory)), m_onChange(std::move(onChange)) {
+    m_thread = std::thread([this]() { run(); });
+}
+
+FileWatcher::~FileWatcher() {
+    m_stopping = true;
+    m_thread.join();
+}
+
+#if defined(__linux__)
+
+void FileWatcher::run() {
+    Trace::get().setThreadName("file watcher");
+    const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0 || inotify_add_watch(fd, m_directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        std::cerr << "[FileWatcher] Cannot watch " << m_directory << "\n";
+        if (fd >= 0) close(fd);
+        return;
+    }
+    std::set<std::string> changed;
+    auto lastEvent = std::chrono::steady_clock::now();
+    alignas(inotify_event) char buffer[4096];
+    while (!m_stopping) {
+        pollfd request{fd, POLLIN, 0};
+        if (poll(&request, 1, kWakeIntervalMs) > 0) {
+            for (;;) {
+                const ssize_t length = read(fd, buffer, sizeof(buffer));
+                if (length <= 0) break;
+                for (ssize_t offset = 0; offset < length;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    if (event->len > 0 && !(event->mask & IN_ISDIR)) changed.insert(event->name);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+                lastEvent = std::chrono::steady_clock::now();
+            }
+        }
+        if (changed.empty() || std::chrono::steady_clock::now() - lastEvent < kSettleTime) continue;
+        for (const auto& name : changed) {
+            TD_TRACE_SCOPE("data", "file changed", name);
+            m_onChange(name);
+        }
+        changed.clear();
+    }
+    close(fd);
+}
+
+#else
+
+void FileWatcher::run() {
+    Trace::get().setThreadName("file watcher");
+    auto snapshot = [this]() {
+        std::map<std::string, std::filesystem::file_time_type> times;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(m_directory, ec)) {
+            if (!entry.is_regular_file(ec)) continue;
+            const auto time = entry.last_write_time(ec);
+            if (!ec) times[entry.path().filename().string()] = time;
+        }
+        return times;
+    };
+    auto known = snapshot();
+    std::set<std::string> changed;
+    auto lastEvent = std::chrono::steady_clock::now();
+    while (!m_stopping) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kWakeIntervalMs));
+        auto current = snapshot();
+        for (const auto& [name, time] : current) {
+            auto it = known.find(name);
+            if (it == known.end() || it->second != time) {
+                changed.insert(name);
+                lastEvent = std::chrono::steady_clock::now();
+            }
+        }
+        known = std::move(current);
+        if (changed.empty() || std::chrono::steady_clock::now() - lastEvent < kSettleTime) continue;
+        for (const auto& name : changed) {
+            TD_TRACE_SCOPE("data", "file changed", name);
+            m_onChange(name);
+        }
+        changed.clear();
+    }
+}
+
+#endif
+
+} // namespace core
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace core {
+
+// Reports files written in one directory (not its subdirectories) by calling
+// `onChange` with the file name on a background thread. Uses inotify on
+// Linux and polls modification times elsewhere. Writes that arrive close
+// together are reported once, after the burst, so an editor saving in several
+// steps triggers a single call.
+class FileWatcher {
+public:
+    using Callback = std::function<void(const std::string& fileName)>;
+
+    FileWatcher(std::filesystem::path directory, Callback onChange);
+    // Waits for a running callback to return.
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+private:
+    void run();
+
+    std::filesystem::path m_directory;
+    Callback m_onChange;
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread;
+};
+
+} // namespace core
@@ -1,12 +1,16 @@
 #include "Game.hpp"
 
+#include "Allocation.hpp"
+#include "Profiler.hpp"
+#include "Trace.hpp"
 #include "../ui/Menus.hpp"
 #include "../ui/LevelSelect.hpp"
 #include "../ui/SettingsPanel.hpp"
 #include "../ui/Codex.hpp"
 #include "../levels/Editor.hpp"
+#include "../math/MathUtils.hpp"
+#include <algorithm>
 #include <iostream>
-#include <map>
 
 namespace core {
 
@@ -16,12 +20,20 @@ ui::LevelSelect g_levelSelect;
 ui::SettingsPanel g_settingsPanel;
 ui::CodexView g_codex;
 levels::LevelEditor g_editor;
+
+constexpr float kCameraPanSpeed = 600.f; // pixels per second, unaffected by game speed
+constexpr float kLoadingBarWidth = 240.f;
+constexpr float kLoadingBarHeight = 8.f;
+
+#if TD_PROFILER
+// Seconds of play before containers are expected to have reached steady-state capacity.
+constexpr float kAllocationAuditWarmup = 5.f;
+#endif
 }
 
 Game::Game(ResourceManager& resources, const data::GameDatabase& database)
-    : m_resources(resources), m_database(database) {
-    m_settings = database.settings;
-    m_save = database.save;
+    : m_resources(resources), m_database(database), m_sim(database),
+      m_tilesTexture(resources.requestTexture("tiles", "textures/placeholder.png")) {
     m_hud.init(resources.font("default"));
     g_mainMenu = ui::MenuScreen{};
     ui::Button start(resources.font("default"), "Play", {420.f, 200.f});
@@ -38,17 +50,64 @@ Game::Game(ResourceManager& resources, const data::GameDatabase& database)
     g_mainMenu.addButton(editorBtn);
 
     g_levelSelect.init(resources.font("default"));
-    std::map<std::string, std::string> levels;
-    for (const auto& [id, level] : database.levels) {
-        levels[id] = level.name;
+    g_codex.init(resources.font("default"));
+    g_editor.init(16, 12, 32, resources.font("default"));
+
+    m_loadingTrack.setSize({kLoadingBarWidth, kLoadingBarHeight});
+    m_loadingTrack.setPosition(420.f, 450.f);
+    m_loadingTrack.setFillColor(sf::Color(40, 40, 60));
+    m_loadingTrack.setOutlineColor(sf::Color::White);
+    m_loadingTrack.setOutlineThickness(1.f);
+    m_loadingFill.setPosition(m_loadingTrack.getPosition());
+    m_loadingFill.setFillColor(sf::Color(110, 170, 110));
+    m_loadingLabel.setFont(resources.font("default"));
+    m_loadingLabel.setCharacterSize(14);
+    m_loadingLabel.setFillColor(sf::Color(200, 200, 200));
+    m_loadingLabel.setPosition(420.f, 466.f);
+    setLoadingProgress(0.f, "Loading");
+}
+
+void Game::setLoadingProgress(float fraction, const std::string& label) {
+    std::lock_guard<std::mutex> lock(m_menuMutex);
+    m_loadingFill.setSize({kLoadingBarWidth * std::clamp(fraction, 0.f, 1.f), kLoadingBarHeight});
+    m_loadingLabel.setString(label);
+}
+
+void Game::finishLoading(LevelCatalog& levels, ThumbnailCache* thumbnails) {
+    TD_TRACE_SCOPE("startup", "Game::finishLoading");
+    std::lock_guard<std::mutex> lock(m_menuMutex);
+    m_levels = &levels;
+    m_settings = m_database.settings;
+    m_save = m_database.save;
+    if (thumbnails) {
+        // Requested the first time a row is in view, so only levels the player scrolls to are read.
+        g_levelSelect.setThumbnailSource([thumbnails, &levels](const std::string& id, bool& failed) {
+            const std::filesystem::path* file = levels.file(id);
+            if (!file) {
+                failed = true;
+                return static_cast<const sf::Texture*>(nullptr);
+            }
+            thumbnails->request(id, *file);
+            return thumbnails->texture(id, failed);
+        });
+    } else {
+        g_levelSelect.setThumbnailSource({});
     }
-    g_levelSelect.setLevels(levels);
+    g_levelSelect.setLevels(levels.headers());
     g_levelSelect.setOnSelect([this](const std::string& id) { startLevel(id); });
+    // Parsing starts while the player is still deciding, so a click rarely waits for it.
+    g_levelSelect.setOnHover([&levels](const std::string& id) { levels.prefetch(id); });
+    g_settingsPanel.init(m_resources.font("default"), m_settings);
+    g_codex.setDatabase(m_database);
+    m_loaded = true;
+}
 
-    g_settingsPanel.init(resources.font("default"), m_settings);
-    g_codex.init(resources.font("default"));
-    g_codex.setDatabase(database);
-    g_editor.init(16, 12, 32, resources.font("default"));
+void Game::editDatabase(const std::function<bool()>& edit) {
+    TD_TRACE_SCOPE("game", "Game::editDatabase");
+    std::lock_guard<std::mutex> lock(m_menuMutex);
+    if (!edit()) return;
+    m_sim.refreshTowers();
+    g_codex.setDatabase(m_database);
 }
 
 void Game::setState(GameState state) {
@@ -59,8 +118,10 @@ void Game::setState(GameState state) {
 }
 
 void Game::handleEvent(const sf::Event& event, const sf::Vector2f& mouseWorld) {
+    std::lock_guard<std::mutex> lock(m_menuMutex);
     if (m_state == GameState::MainMenu) {
-        if (event.type == sf::Event::MouseButtonPressed) {
+        // Every screen behind the menu needs the game data.
+        if (event.type == sf::Event::MouseButtonPressed && m_loaded) {
             g_mainMenu.handleClick(mouseWorld);
         }
         return;
@@ -69,6 +130,10 @@ void Game::handleEvent(const sf::Event& event, const sf::Vector2f& mouseWorld) {
         if (event.type == sf::Event::MouseButtonPressed) {
             g_levelSelect.handleClick(mouseWorld);
         }
+        if (event.type == sf::Event::MouseMoved) {
+            g_levelSelect.handleHover(mouseWorld);
+        }
+        g_levelSelect.handleEvent(event);
         if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
             setState(GameState::MainMenu);
         }
@@ -81,6 +146,7 @@ void Game::handleEvent(const sf::Event& event, const sf::Vector2f& mouseWorld) {
         return;
     }
     if (m_state == GameState::Codex) {
+        g_codex.handleEvent(event);
         if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
             setState(GameState::MainMenu);
         }
@@ -94,6 +160,9 @@ void Game::handleEvent(const sf::Event& event, const sf::Vector2f& mouseWorld) {
         return;
     }
 
+    if (event.type == sf::Event::MouseMoved) {
+        m_mouse = mouseWorld;
+    }
     if (event.type == sf::Event::KeyPressed) {
         if (event.key.code == sf::Keyboard::P) {
             m_paused = !m_paused;
@@ -103,194 +172,198 @@ void Game::handleEvent(const sf::Event& event, const sf::Vector2f& mouseWorld) {
         if (event.key.code == sf::Keyboard::Num3) m_speed = SpeedMode::Triple;
     }
     if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
-        tryPlaceTower(mouseWorld);
+        tryPlaceTower(screenToWorld(mouseWorld));
     }
 }
 
 void Game::update(float dt) {
+    if (m_state == GameState::Gameplay) {
+        updateCamera(dt);
+    }
     if (m_state == GameState::Gameplay && !m_paused) {
         const float speedMultiplier = static_cast<float>(m_speed);
-        dt *= speedMultiplier;
-        updateEconomy(dt);
-        int livesLost = 0;
-        systems::updateMovement(m_registry, m_paths, dt, static_cast<float>(m_currentLevel.definition.tileSize), livesLost);
-        m_lives -= livesLost;
-        if (m_lives <= 0) {
+        {
+#if TD_PROFILER
+            AllocationAudit audit(m_sim.elapsed() > kAllocationAuditWarmup);
+#endif
+            m_sim.tick(dt * speedMultiplier);
+        }
+        if (m_sim.outcome() == SimulationOutcome::Defeat) {
             m_state = GameState::Defeat;
             return;
         }
-
-        m_grid.clear();
-        m_enemyOrder.clear();
-        for (const auto& [entity, stats] : m_registry.m_enemyStats) {
-            m_enemyOrder.push_back(entity);
-            m_grid.insert(m_enemyOrder.size() - 1, m_registry.m_transforms[entity].position);
+        if (m_sim.outcome() == SimulationOutcome::Victory) {
+            m_state = GameState::Victory;
         }
+    }
+}
 
-        systems::updateStatus(m_registry, dt, m_database.balance);
-        systems::updateTargeting(m_registry, m_grid, m_enemyOrder, dt);
-        systems::updateFiring(m_registry, m_projectilePool, dt, m_database.balance);
-        systems::updateProjectiles(m_registry, dt, m_database.balance);
-        systems::updateCleanup(m_registry, m_projectilePool, m_effectPool);
-
-        if (!m_pendingSpawns.empty()) {
-            m_spawnTimer -= dt;
-            if (m_spawnTimer <= 0.f) {
-                auto spawn = m_pendingSpawns.back();
-                m_pendingSpawns.pop_back();
-                spawnEnemyFromWave(spawn);
-                if (!m_pendingSpawns.empty()) {
-                    m_spawnTimer = spawn.delay;
-                }
-            }
-        } else if (m_waveInProgress && m_registry.m_enemyStats.empty()) {
-            m_waveInProgress = false;
-            m_coins += static_cast<int>(m_database.balance.waveClearBonus);
-            if (const auto waveDataIt = m_database.waves.find(m_currentLevelId);
-                waveDataIt != m_database.waves.end() &&
-                m_waveIndex >= static_cast<int>(waveDataIt->second.waves.size())) {
-                m_state = GameState::Victory;
-            }
-        }
+void Game::publish(RenderSnapshot& snapshot) {
+    TD_PROFILE_SCOPE("Game::publish");
+    snapshot.tick = ++m_ticks;
+    snapshot.state = m_state;
+    snapshot.level = m_level;
+    const bool inLevel = m_state == GameState::Gameplay || m_state == GameState::Paused ||
+                         m_state == GameState::Victory || m_state == GameState::Defeat;
+    if (!inLevel) return;
+    fitCamera();
+    snapshot.camera = m_camera;
+    const sf::FloatRect area = render::visibleArea(m_camera);
+    render::extractVisible(m_sim, area, snapshot.entities);
+    snapshot.particles.clear();
+    m_sim.particles().appendQuads(snapshot.particles, area);
+    ui::HudValues& hud = snapshot.hud;
+    hud.lives = m_sim.lives();
+    hud.maxLives = m_sim.level().definition.startLives;
+    hud.coins = m_sim.coins();
+    hud.wave = m_sim.waveIndex();
+    hud.waveCount = m_sim.waveCount();
+    hud.waveProgress = m_sim.waveProgress();
+    hud.speed = static_cast<int>(m_speed);
+    hud.paused = m_paused;
+    describeHoveredTower(hud);
+}
 
-        if (!m_waveInProgress) {
-            m_waveTimer -= dt;
-            if (m_waveTimer <= 0.f) {
-                spawnWave();
-            }
-        }
+void Game::describeHoveredTower(ui::HudValues& hud) const {
+    hud.showTower = false;
+    const sf::Vector2f cursor = screenToWorld(m_mouse);
+    const float pickRadius = static_cast<float>(m_sim.level().definition.tileSize) * 0.5f;
+    const auto& registry = m_sim.registry();
+    for (const auto& [entity, stats] : registry.m_towerStats) {
+        auto transformIt = registry.m_transforms.find(entity);
+        if (transformIt == registry.m_transforms.end()) continue;
+        if (math::distance(transformIt->second.position, cursor) > pickRadius) continue;
+        auto definitionIt = m_database.towers.find(stats.id);
+        hud.showTower = true;
+        hud.tower.name = definitionIt != m_database.towers.end() ? definitionIt->second.name : stats.id;
+        hud.tower.level = stats.level;
+        hud.tower.damage = stats.damage;
+        hud.tower.fireRate = stats.fireRate;
+        hud.tower.range = stats.range;
+        return;
+    }
+}
 
-        m_hud.update(m_lives, m_coins, m_waveIndex, static_cast<int>(m_speed), m_paused);
-    } else if (m_state == GameState::Gameplay && m_paused) {
-        m_hud.update(m_lives, m_coins, m_waveIndex, static_cast<int>(m_speed), m_paused);
+void Game::draw(sf::RenderWindow& window, const RenderSnapshot& snapshot) {
+    TD_PROFILE_SCOPE("Game::draw");
+    TD_TRACE_SCOPE("render", "Game::draw");
+    switch (snapshot.state) {
+        case GameState::Gameplay:
+        case GameState::Paused:
+        case GameState::Victory:
+        case GameState::Defeat:
+            drawLevel(window, snapshot);
+            break;
+        default:
+            drawMenus(window, snapshot.state);
+            break;
     }
 }
 
-void Game::draw(sf::RenderWindow& window) {
-    if (m_state == GameState::MainMenu) {
+void Game::drawMenus(sf::RenderWindow& window, GameState state) {
+    std::lock_guard<std::mutex> lock(m_menuMutex);
+    if (state == GameState::MainMenu) {
         g_mainMenu.draw(window);
-        return;
-    }
-    if (m_state == GameState::LevelSelect) {
+        if (!m_loaded) {
+            window.draw(m_loadingTrack);
+            window.draw(m_loadingFill);
+            window.draw(m_loadingLabel);
+        }
+    } else if (state == GameState::LevelSelect) {
         g_levelSelect.draw(window);
-        return;
-    }
-    if (m_state == GameState::Settings) {
+    } else if (state == GameState::Settings) {
         g_settingsPanel.draw(window);
-        return;
-    }
-    if (m_state == GameState::Codex) {
+    } else if (state == GameState::Codex) {
         g_codex.draw(window);
-        return;
-    }
-    if (m_state == GameState::Editor) {
+    } else if (state == GameState::Editor) {
         g_editor.draw(window);
-        return;
     }
-    if (m_state == GameState::Gameplay || m_state == GameState::Paused || m_state == GameState::Victory || m_state == GameState::Defeat) {
-        m_tilemap.draw(window);
-        for (const auto& [entity, render] : m_registry.m_renderables) {
-            auto transformIt = m_registry.m_transforms.find(entity);
-            if (transformIt == m_registry.m_transforms.end()) continue;
-            sf::CircleShape shape(12.f);
-            shape.setPosition(transformIt->second.position - sf::Vector2f{12.f, 12.f});
-            if (m_registry.m_enemyStats.count(entity)) {
-                shape.setFillColor(sf::Color::Red);
-            } else if (m_registry.m_towerStats.count(entity)) {
-                shape.setFillColor(sf::Color::Blue);
-            } else if (m_registry.m_projectiles.count(entity)) {
-                shape.setFillColor(sf::Color::Yellow);
-                shape.setRadius(6.f);
+}
+
+void Game::drawLevel(sf::RenderWindow& window, const RenderSnapshot& snapshot) {
+    // A tilemap built on the placeholder is built again once the tile texture has streamed in.
+    const bool tilesArrived = m_tilemapOnPlaceholder && m_resources.textureReady(m_tilesTexture);
+    if (snapshot.level != m_tilemapLevel || tilesArrived) {
+        m_tilemapLevel = snapshot.level;
+        m_tilemapOnPlaceholder = false;
+        if (m_tilemapLevel) {
+            const TextureAtlas& atlas = m_resources.atlas();
+            AtlasHandle tiles = atlas.handle("tiles_" + m_tilemapLevel->definition.biome);
+            if (tiles == kInvalidAtlasHandle) tiles = atlas.handle("tiles");
+            if (tiles != kInvalidAtlasHandle) {
+                const AtlasRegion& region = atlas.region(tiles);
+                m_tilemap.build(*m_tilemapLevel, atlas.page(region.page), region.rect);
+            } else {
+                m_tilemapOnPlaceholder = !m_resources.textureReady(m_tilesTexture);
+                const sf::Texture& texture = m_resources.texture(m_tilesTexture);
+                m_tilemap.build(*m_tilemapLevel, texture,
+                                {0, 0, static_cast<int>(texture.getSize().x), static_cast<int>(texture.getSize().y)});
             }
-            window.draw(shape);
-        }
-        m_hud.draw(window);
-        if (m_state == GameState::Victory) {
-            sf::Text text("Victory!", m_resources.font("default"), 32);
-            text.setPosition(420.f, 200.f);
-            window.draw(text);
-        }
-        if (m_state == GameState::Defeat) {
-            sf::Text text("Defeat", m_resources.font("default"), 32);
-            text.setPosition(420.f, 200.f);
-            window.draw(text);
         }
     }
+
+    const sf::View screen = window.getView();
+    window.setView(snapshot.camera);
+    m_tilemap.draw(window);
+    m_entities.build(snapshot.entities);
+    m_entities.draw(window);
+    if (!snapshot.particles.empty()) {
+        window.draw(snapshot.particles.data(), snapshot.particles.size(), sf::Quads);
+    }
+    window.setView(screen);
+
+    m_hud.update(snapshot.hud);
+    m_hud.draw(window);
+    if (snapshot.state == GameState::Victory) {
+        sf::Text text("Victory!", m_resources.font("default"), 32);
+        text.setPosition(420.f, 200.f);
+        window.draw(text);
+    }
+    if (snapshot.state == GameState::Defeat) {
+        sf::Text text("Defeat", m_resources.font("default"), 32);
+        text.setPosition(420.f, 200.f);
+        window.draw(text);
+    }
 }
 
 void Game::startLevel(const std::string& id) {
-    auto it = m_database.levels.find(id);
-    if (it == m_database.levels.end()) return;
-    m_currentLevelId = id;
-    m_currentLevel = levels::buildLevel(it->second);
-    m_tilemap.build(m_currentLevel, m_resources.texture("tiles"));
-    m_paths.paths = m_currentLevel.paths;
-    m_registry = ecs::Registry{};
-    m_projectilePool.available.clear();
-    m_effectPool.available.clear();
-    m_enemyOrder.clear();
-    m_lives = it->second.startLives;
-    m_coins = it->second.startCoins;
-    m_waveIndex = 0;
-    m_waveTimer = 2.f;
-    m_waveInProgress = false;
+    TD_TRACE_SCOPE("game", "Game::startLevel", id);
+    const auto level = m_levels->load(id);
+    if (!level) return;
+    m_sim.start(*level);
+    m_level = std::make_shared<const levels::LevelRuntime>(m_sim.level());
+    m_camera.setCenter(0.f, 0.f);
     m_paused = false;
     m_state = GameState::Gameplay;
 }
 
-void Game::spawnWave() {
-    auto waveDataIt = m_database.waves.find(m_currentLevelId);
-    if (waveDataIt == m_database.waves.end()) return;
-    if (m_waveIndex >= static_cast<int>(waveDataIt->second.waves.size())) return;
-    const auto& wave = waveDataIt->second.waves[m_waveIndex];
-    m_pendingSpawns.clear();
-    for (const auto& spawn : wave.enemies) {
-        m_pendingSpawns.push_back(spawn);
-    }
-    std::reverse(m_pendingSpawns.begin(), m_pendingSpawns.end());
-    if (!m_pendingSpawns.empty()) {
-        m_spawnTimer = m_pendingSpawns.back().delay;
-    }
-    m_waveIndex++;
-    m_waveInProgress = true;
-    m_waveTimer = wave.spawnInterval;
+void Game::updateCamera(float dt) {
+    sf::Vector2f pan;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) pan.x -= 1.f;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) pan.x += 1.f;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up)) pan.y -= 1.f;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) pan.y += 1.f;
+    m_camera.move(pan * kCameraPanSpeed * dt);
 }
 
-void Game::spawnEnemyFromWave(const data::WaveSpawn& spawn) {
-    auto enemyDefIt = m_database.enemies.find(spawn.type);
-    if (enemyDefIt == m_database.enemies.end()) return;
-    for (int i = 0; i < spawn.count; ++i) {
-        const auto& path = m_paths.paths[i % std::max<std::size_t>(1, m_paths.paths.size())];
-        entities::spawnEnemy(m_registry, enemyDefIt->second, path);
-    }
+void Game::fitCamera() {
+    m_camera.setSize(m_screenSize);
+    const sf::Vector2f half = m_screenSize * 0.5f;
+    const auto& def = m_sim.level().definition;
+    const sf::Vector2f world{static_cast<float>(def.width * def.tileSize), static_cast<float>(def.height * def.tileSize)};
+    sf::Vector2f center = m_camera.getCenter();
+    // A level smaller than the screen stays anchored to the top-left corner.
+    center.x = world.x <= m_screenSize.x ? half.x : std::clamp(center.x, half.x, world.x - half.x);
+    center.y = world.y <= m_screenSize.y ? half.y : std::clamp(center.y, half.y, world.y - half.y);
+    m_camera.setCenter(center);
 }
 
-void Game::updateEconomy(float dt) {
-    m_incomeTimer += dt;
-    if (m_incomeTimer >= 1.f) {
-        int totalIncome = 0;
-        for (const auto& [entity, eco] : m_registry.m_economy) {
-            totalIncome += static_cast<int>(eco.income);
-        }
-        m_coins += totalIncome;
-        m_incomeTimer = 0.f;
-    }
+sf::Vector2f Game::screenToWorld(const sf::Vector2f& screen) const {
+    return screen - m_camera.getSize() * 0.5f + m_camera.getCenter();
 }
 
 void Game::tryPlaceTower(const sf::Vector2f& position) {
-    for (const auto& cell : m_currentLevel.definition.buildable) {
-        sf::Vector2f cellCenter = {cell.x * static_cast<float>(m_currentLevel.definition.tileSize) + m_currentLevel.definition.tileSize * 0.5f,
-                                   cell.y * static_cast<float>(m_currentLevel.definition.tileSize) + m_currentLevel.definition.tileSize * 0.5f};
-        if (math::distance(cellCenter, position) < m_currentLevel.definition.tileSize * 0.5f) {
-            auto towerIt = m_database.towers.find("arrow_mk1");
-            if (towerIt == m_database.towers.end()) return;
-            if (m_coins < towerIt->second.cost) return;
-            m_coins -= towerIt->second.cost;
-            entities::spawnTower(m_registry, towerIt->second, cellCenter);
-            break;
-        }
-    }
+    m_sim.placeTower("arrow_mk1", position);
 }
 
 } // namespace core
-
@@ -2,43 +2,70 @@
 
 #include "DataLoader.hpp"
 #include "GameData.hpp"
+#include "GameState.hpp"
+#include "LevelCatalog.hpp"
+#include "RenderSnapshot.hpp"
 #include "ResourceManager.hpp"
-#include "../ecs/Registry.hpp"
-#include "../systems/Systems.hpp"
-#include "../entities/Entities.hpp"
-#include "../levels/LevelLoader.hpp"
+#include "Simulation.hpp"
+#include "ThumbnailCache.hpp"
 #include "../levels/Tilemap.hpp"
-#include "../math/SpatialHash.hpp"
+#include "../render/EntityBatcher.hpp"
+#include "../render/RenderList.hpp"
 #include "../ui/HUD.hpp"
 #include <SFML/Graphics.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
 
 namespace core {
 
-enum class GameState { MainMenu, LevelSelect, Settings, Codex, Gameplay, Paused, Victory, Defeat, Editor };
-
-enum class SpeedMode { Normal = 1, Double = 2, Triple = 3 };
-
+// handleEvent, update and publish run on the simulation thread; draw runs on
+// the render thread and only reads the published snapshot, except for menu
+// screens, which it draws under the same lock that guards their event handling.
 class Game {
 public:
+    // Needs only the "default" font: `database` may still be loading, and the
+    // main menu shows a progress bar with its buttons disabled until
+    // finishLoading() is called once the database is complete.
     Game(ResourceManager& resources, const data::GameDatabase& database);
 
+    void setLoadingProgress(float fraction, const std::string& label);
+    // Levels are listed from and loaded through `levels`. Both it and the
+    // optional `thumbnails` must outlive the game.
+    void finishLoading(LevelCatalog& levels, ThumbnailCache* thumbnails = nullptr);
+
+    void setScreenSize(const sf::Vector2f& size) { m_screenSize = size; }
+    // Simulation thread, after finishLoading(). Runs `edit`, which may change
+    // the database this game was given, while the render thread cannot read
+    // it. If `edit` returns true, placed towers take their stats from the
+    // changed definitions and the codex is rebuilt.
+    void editDatabase(const std::function<bool()>& edit);
+
     void handleEvent(const sf::Event& event, const sf::Vector2f& mouseWorld);
     void update(float dt);
-    void draw(sf::RenderWindow& window);
+    void publish(RenderSnapshot& snapshot);
+    void draw(sf::RenderWindow& window, const RenderSnapshot& snapshot);
 
     GameState state() const { return m_state; }
+    const Simulation& simulation() const { return m_sim; }
+    SpeedMode speed() const { return m_speed; }
     void setState(GameState state);
 
 private:
     void startLevel(const std::string& id);
     void updateMenus();
-    void spawnWave();
-    void spawnEnemyFromWave(const data::WaveSpawn& spawn);
-    void updateEconomy(float dt);
     void tryPlaceTower(const sf::Vector2f& position);
+    void updateCamera(float dt);
+    // Clamps the camera to the level and matches its size to the screen.
+    void fitCamera();
+    sf::Vector2f screenToWorld(const sf::Vector2f& screen) const;
+    void describeHoveredTower(ui::HudValues& hud) const;
+    void drawMenus(sf::RenderWindow& window, GameState state);
+    void drawLevel(sf::RenderWindow& window, const RenderSnapshot& snapshot);
 
     ResourceManager& m_resources;
     const data::GameDatabase& m_database;
+    LevelCatalog* m_levels = nullptr;
 
     GameState m_state = GameState::MainMenu;
     SpeedMode m_speed = SpeedMode::Normal;
@@ -46,28 +73,27 @@ private:
     data::SettingsData m_settings;
     data::SaveData m_save;
 
-    levels::LevelRuntime m_currentLevel;
+    Simulation m_sim;
+    std::shared_ptr<const levels::LevelRuntime> m_level;
+    sf::View m_camera;
+    sf::Vector2f m_screenSize{1280.f, 720.f};
+    sf::Vector2f m_mouse; // screen space
+    std::uint64_t m_ticks = 0;
+    std::mutex m_menuMutex;
+    bool m_loaded = false; // guarded by m_menuMutex
+    sf::RectangleShape m_loadingTrack;
+    sf::RectangleShape m_loadingFill;
+    sf::Text m_loadingLabel;
+
+    // Render thread only.
     levels::TilemapRenderer m_tilemap;
-
-    ecs::Registry m_registry;
-    systems::PathContext m_paths;
-    systems::ProjectilePool m_projectilePool;
-    systems::EffectPool m_effectPool;
-    math::SpatialHashGrid m_grid;
-    std::vector<ecs::Entity> m_enemyOrder;
-
+    std::shared_ptr<const levels::LevelRuntime> m_tilemapLevel;
+    TextureHandle m_tilesTexture; // drawn when the atlas has no tile image
+    bool m_tilemapOnPlaceholder = false; // m_tilemap uses the placeholder until m_tilesTexture is ready
+    render::EntityBatcher m_entities;
     ui::HUD m_hud;
 
-    int m_lives = 20;
-    int m_coins = 0;
-    int m_waveIndex = 0;
-    float m_waveTimer = 0.f;
-    bool m_waveInProgress = false;
-    std::vector<data::WaveSpawn> m_pendingSpawns;
-    float m_spawnTimer = 0.f;
-    std::string m_currentLevelId;
     bool m_paused = false;
-    float m_incomeTimer = 0.f;
 };
 
 } // namespace core
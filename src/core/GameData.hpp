@@ -23,6 +23,8 @@ struct UpgradeModifier {
     float chain = 0.f;
     float pierce = 0.f;
     float income = 0.f;
+
+    bool operator==(const UpgradeModifier&) const = default;
 };
 
 struct BranchModifier {
@@ -42,6 +44,8 @@ struct BranchModifier {
     float income = 0.f;
     float magicResistShred = 0.f;
     bool canHitFlying = false;
+
+    bool operator==(const BranchModifier&) const = default;
 };
 
 struct TowerDefinition {
@@ -67,6 +71,8 @@ struct TowerDefinition {
     std::vector<UpgradeModifier> upgrades;
     BranchModifier branchA;
     BranchModifier branchB;
+
+    bool operator==(const TowerDefinition&) const = default;
 };
 
 struct EnemyDefinition {
@@ -79,6 +85,8 @@ struct EnemyDefinition {
     int reward = 5;
     std::vector<std::string> abilities;
     std::vector<std::string> tags;
+
+    bool operator==(const EnemyDefinition&) const = default;
 };
 
 struct StatusDefinition {
@@ -89,22 +97,30 @@ struct StatusDefinition {
     float stun = 0.f;
     float armor = 0.f;
     float magicResist = 0.f;
+
+    bool operator==(const StatusDefinition&) const = default;
 };
 
 struct WaveSpawn {
     std::string type;
     int count = 0;
     float delay = 0.f;
+
+    bool operator==(const WaveSpawn&) const = default;
 };
 
 struct WaveDefinition {
     int id = 0;
     float spawnInterval = 1.f;
     std::vector<WaveSpawn> enemies;
+
+    bool operator==(const WaveDefinition&) const = default;
 };
 
 struct LevelWaves {
     std::vector<WaveDefinition> waves;
+
+    bool operator==(const LevelWaves&) const = default;
 };
 
 struct LevelDefinition {
@@ -121,6 +137,20 @@ struct LevelDefinition {
     std::string wavesId;
     int startCoins = 300;
     int startLives = 20;
+
+    bool operator==(const LevelDefinition&) const = default;
+};
+
+// The part of a level file the level list needs, read without parsing the rest.
+struct LevelHeader {
+    std::string id;
+    std::string name;
+    std::string biome;
+    int width = 32;
+    int height = 18;
+    int tileSize = 40;
+
+    bool operator==(const LevelHeader&) const = default;
 };
 
 struct BalanceDefinition {
@@ -134,6 +164,8 @@ struct BalanceDefinition {
     float killRewardBonus = 0.f;
     float waveClearBonus = 0.f;
     float sellRefund = 0.5f;
+
+    bool operator==(const BalanceDefinition&) const = default;
 };
 
 struct SettingsData {
@@ -142,6 +174,10 @@ struct SettingsData {
     int gameSpeed = 1;
     std::string graphicsQuality = "medium";
     std::string colorBlindMode = "normal";
+    float hitchBudgetMs = 50.f; // 0 disables hitch captures
+    int hitchHistoryFrames = 120;
+
+    bool operator==(const SettingsData&) const = default;
 };
 
 struct SaveData {
@@ -150,6 +186,8 @@ struct SaveData {
     std::vector<std::string> badges;
     std::vector<std::string> unlockedTowers;
     std::vector<std::string> completedLevels;
+
+    bool operator==(const SaveData&) const = default;
 };
 
 struct GameDatabase {
@@ -160,6 +198,8 @@ struct GameDatabase {
     BalanceDefinition balance;
     SettingsData settings;
     SaveData save;
+
+    bool operator==(const GameDatabase&) const = default;
 };
 
 } // namespace data
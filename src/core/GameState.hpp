@@ -0,0 +1,9 @@
+#pragma once
+
+namespace core {
+
+enum class GameState { MainMenu, LevelSelect, Settings, Codex, Gameplay, Paused, Victory, Defeat, Editor };
+
+enum class SpeedMode { Normal = 1, Double = 2, Triple = 3 };
+
+} // namespace core
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace core {
+
+// 64-bit FNV-1a. Used for cache keys, not for anything security related.
+constexpr std::uint64_t kFnvOffset = 14695981039346656037ull;
+
+inline std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash = kFnvOffset) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline std::uint64_t fnv1a(std::string_view text, std::uint64_t hash = kFnvOffset) {
+    return fnv1a(text.data(), text.size(), hash);
+}
+
+inline std::string hashToHex(std::uint64_t hash) {
+    static constexpr char kDigits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i, hash >>= 4) {
+        hex[static_cast<std::size_t>(i)] = kDigits[hash & 0xf];
+    }
+    return hex;
+}
+
+} // namespace core
@@ -0,0 +1,171 @@
+#include "HitchDetector.hpp"
+
+#include "Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+namespace core {
+
+using nlohmann::json;
+
+namespace {
+
+constexpr std::size_t kInputHistory = 64;
+
+const char* eventTypeName(sf::Event::EventType type) {
+    switch (type) {
+        case sf::Event::KeyPressed: return "keyPressed";
+        case sf::Event::KeyReleased: return "keyReleased";
+        case sf::Event::MouseButtonPressed: return "mousePressed";
+        case sf::Event::MouseButtonReleased: return "mouseReleased";
+        case sf::Event::MouseWheelScrolled: return "mouseWheel";
+        default: return "other";
+    }
+}
+
+std::string captureFileName() {
+    const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", std::localtime(&now));
+    return std::string("hitch_") + stamp + ".json";
+}
+
+json componentCounts(const ecs::Registry& registry) {
+    return json{{"transforms", registry.m_transforms.size()},
+                {"velocities", registry.m_velocities.size()},
+                {"renderables", registry.m_renderables.size()},
+                {"health", registry.m_health.size()},
+                {"armor", registry.m_armor.size()},
+                {"magicResist", registry.m_magicResist.size()},
+                {"enemyStats", registry.m_enemyStats.size()},
+                {"towerStats", registry.m_towerStats.size()},
+                {"projectiles", registry.m_projectiles.size()},
+                {"statusContainers", registry.m_statusContainers.size()},
+                {"targeting", registry.m_targeting.size()},
+                {"lifetimes", registry.m_lifetimes.size()},
+                {"owners", registry.m_owners.size()},
+                {"experience", registry.m_experience.size()},
+                {"economy", registry.m_economy.size()},
+                {"buffAura", registry.m_buffAura.size()}};
+}
+
+} // namespace
+
+HitchDetector::HitchDetector(HitchConfig config) : m_config(std::move(config)) {
+    m_frames.resize(std::max<std::size_t>(1, m_config.historyFrames));
+    m_inputs.reserve(kInputHistory);
+}
+
+HitchDetector::~HitchDetector() {
+    if (m_writer.joinable()) m_writer.join();
+}
+
+void HitchDetector::recordInput(const sf::Event& event, const sf::Vector2f& mouseWorld) {
+    InputRecord record;
+    record.frame = m_frame;
+    record.type = event.type;
+    record.world = mouseWorld;
+    if (event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased) {
+        record.code = static_cast<int>(event.key.code);
+    } else if (event.type == sf::Event::MouseButtonPressed || event.type == sf::Event::MouseButtonReleased) {
+        record.code = static_cast<int>(event.mouseButton.button);
+    } else if (event.type != sf::Event::MouseWheelScrolled) {
+        return;
+    }
+    if (m_inputs.size() < kInputHistory) {
+        m_inputs.push_back(record);
+    } else {
+        m_inputs[m_inputCursor] = record;
+    }
+    m_inputCursor = (m_inputCursor + 1) % kInputHistory;
+}
+
+void HitchDetector::endFrame(float dt, double tickMs, const Game& game) {
+    const FrameRecord record{m_frame, dt, static_cast<float>(tickMs)};
+    m_frames[m_frame % m_frames.size()] = record;
+    ++m_frame;
+    m_sinceCapture += dt;
+
+    if (m_config.budgetMs <= 0.f || tickMs <= m_config.budgetMs) return;
+    if (game.state() != GameState::Gameplay) return;
+    if (m_captures >= m_config.maxCaptures) return;
+    if (m_captures > 0 && m_sinceCapture < m_config.cooldownSeconds) return;
+    capture(record, game);
+}
+
+void HitchDetector::capture(const FrameRecord& hitch, const Game& game) {
+    const Simulation& sim = game.simulation();
+
+    json::array_t frames;
+    const std::size_t history = std::min<std::size_t>(m_frames.size(), m_frame);
+    for (std::size_t i = m_frame - history; i < m_frame; ++i) {
+        const auto& frame = m_frames[i % m_frames.size()];
+        frames.push_back(json{{"frame", frame.frame}, {"dt", frame.dt}, {"tickMs", frame.tickMs}});
+    }
+
+    json::array_t inputs;
+    for (std::size_t i = 0; i < m_inputs.size(); ++i) {
+        const std::size_t index = m_inputs.size() < kInputHistory ? i : (m_inputCursor + i) % kInputHistory;
+        const auto& input = m_inputs[index];
+        inputs.push_back(json{{"frame", input.frame},
+                              {"type", eventTypeName(input.type)},
+                              {"code", input.code},
+                              {"x", input.world.x},
+                              {"y", input.world.y}});
+    }
+
+    json::array_t samples;
+#if TD_PROFILER
+    const std::uint64_t profilerFrame = Profiler::get().frameIndex();
+    const std::uint64_t firstFrame = profilerFrame > history ? profilerFrame - history : 0;
+    for (const auto& sample : Profiler::get().samplesSince(firstFrame)) {
+        samples.push_back(json{{"frame", sample.frame},
+                               {"thread", static_cast<int>(sample.thread)},
+                               {"depth", static_cast<int>(sample.depth)},
+                               {"name", sample.name},
+                               {"beginUs", static_cast<double>(sample.beginNs) / 1e3},
+                               {"durationUs", static_cast<double>(sample.endNs - sample.beginNs) / 1e3},
+                               {"allocations", static_cast<int>(sample.allocations)}});
+    }
+#endif
+
+    json capture{{"version", 1},
+                 {"frame", hitch.frame},
+                 {"tickMs", hitch.tickMs},
+                 {"budgetMs", m_config.budgetMs},
+                 {"dt", hitch.dt},
+                 {"speed", static_cast<int>(game.speed())},
+                 {"level", sim.levelId()},
+                 {"waveIndex", sim.waveIndex()},
+                 {"pendingSpawns", sim.pendingSpawnCount()},
+                 {"components", componentCounts(sim.registry())},
+                 {"frames", json(frames)},
+                 {"inputs", json(inputs)},
+                 {"samples", json(samples)},
+                 {"simulation", sim.snapshot()}};
+
+    const std::filesystem::path path = m_config.directory / captureFileName();
+    ++m_captures;
+    m_sinceCapture = 0.f;
+    std::cerr << "[Hitch] " << hitch.tickMs << " ms tick exceeded the " << m_config.budgetMs
+              << " ms budget, writing " << path.string() << "\n";
+
+    // Serialising a large snapshot takes a while; keep it off the game thread.
+    if (m_writer.joinable()) m_writer.join();
+    m_writer = std::thread([path, capture = std::move(capture)]() {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "[Hitch] Failed to write " << path.string() << "\n";
+            return;
+        }
+        file << capture.dump(2) << "\n";
+    });
+}
+
+} // namespace core
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Game.hpp"
+#include <SFML/Window/Event.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+namespace core {
+
+struct HitchConfig {
+    float budgetMs = 50.f; // 0 disables captures
+    std::size_t historyFrames = 120;
+    std::size_t maxCaptures = 10;
+    float cooldownSeconds = 10.f;
+    std::filesystem::path directory = "captures";
+};
+
+// Watches gameplay tick times. When a tick exceeds the budget it writes a capture
+// (recent frame times, profiler samples when compiled in, recent input and a
+// Simulation snapshot) to <directory>/hitch_<time>.json on a background thread.
+// `towerdefense_headless --replay FILE` restores and re-runs the capture.
+class HitchDetector {
+public:
+    explicit HitchDetector(HitchConfig config = {});
+    ~HitchDetector();
+
+    HitchDetector(const HitchDetector&) = delete;
+    HitchDetector& operator=(const HitchDetector&) = delete;
+
+    void recordInput(const sf::Event& event, const sf::Vector2f& mouseWorld);
+    // Once per frame, after the profiler frame has been closed.
+    void endFrame(float dt, double tickMs, const Game& game);
+
+    std::size_t captureCount() const { return m_captures; }
+
+private:
+    struct FrameRecord {
+        std::uint64_t frame = 0;
+        float dt = 0.f;
+        float tickMs = 0.f;
+    };
+
+    struct InputRecord {
+        std::uint64_t frame = 0;
+        sf::Event::EventType type = sf::Event::KeyPressed;
+        int code = 0; // key code or mouse button
+        sf::Vector2f world;
+    };
+
+    void capture(const FrameRecord& hitch, const Game& game);
+
+    HitchConfig m_config;
+    std::uint64_t m_frame = 0;
+    std::vector<FrameRecord> m_frames; // ring of historyFrames entries
+    std::vector<InputRecord> m_inputs; // ring of kInputHistory entries
+    std::size_t m_inputCursor = 0;
+    std::size_t m_captures = 0;
+    float m_sinceCapture = 0.f;
+    std::thread m_writer;
+};
+
+} // namespace core
@@ -0,0 +1,113 @@
+#include "JobSystem.hpp"
+
+#include "Trace.hpp"
+#include <algorithm>
+#include <string>
+
+namespace core {
+
+JobSystem::JobSystem(unsigned workerCount) {
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(job));
+        ++m_pending;
+    }
+    m_wake.notify_one();
+}
+
+void JobSystem::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_pending == 0; });
+}
+
+namespace {
+
+// Shared by the caller and the helper jobs of one parallelFor call. Helpers
+// capture only a pointer to it so their std::function stays in small-buffer
+// storage and queuing them does not allocate.
+struct ParallelForState {
+    const std::function<void(std::size_t)>* fn = nullptr;
+    std::size_t count = 0;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+    std::atomic<std::size_t> helpersRunning{0};
+
+    void drain() {
+        for (std::size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            (*fn)(i);
+            done.fetch_add(1, std::memory_order_release);
+        }
+    }
+};
+
+} // namespace
+
+void JobSystem::parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn) {
+    if (count == 0) return;
+    ParallelForState state;
+    state.fn = &fn;
+    state.count = count;
+    const std::size_t helpers = std::min<std::size_t>(m_workers.size(), count - 1);
+    state.helpersRunning.store(helpers);
+    for (std::size_t i = 0; i < helpers; ++i) {
+        ParallelForState* shared = &state;
+        submit([shared]() {
+            shared->drain();
+            shared->helpersRunning.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    {
+        TD_TRACE_SCOPE("job", "parallelFor", std::to_string(count));
+        state.drain();
+    }
+    // Helpers reference this frame's state, so wait until every one has left drain().
+    while (state.done.load(std::memory_order_acquire) < count || state.helpersRunning.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+void JobSystem::workerLoop() {
+    Trace::get().setThreadName("job worker");
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+            if (m_stopping && m_queue.empty()) return;
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        {
+            TD_TRACE_SCOPE("job", "job");
+            job();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_pending;
+        }
+        m_idle.notify_all();
+    }
+}
+
+} // namespace core
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core {
+
+// Fixed-size worker pool. Jobs run in FIFO order; parallelFor splits an index
+// range across the workers and the calling thread.
+class JobSystem {
+public:
+    explicit JobSystem(unsigned workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void submit(std::function<void()> job);
+    void wait();
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+    unsigned workerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::size_t m_pending = 0;
+    bool m_stopping = false;
+};
+
+} // namespace core
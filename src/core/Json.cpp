@@ -0,0 +1,456 @@
+#include "Json.hpp"
+
+#include "Trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace core {
+
+namespace {
+
+constexpr double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+constexpr int kMaxExactPow10 = 22;
+constexpr std::uint64_t kMaxExactMantissa = 1ull << 53;
+constexpr int kMaxSignificantDigits = 19; // still fits in a uint64
+constexpr int kExponentLimit = 100000;    // far past double range; stops int overflow on absurd input
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// mantissa * 10^exponent. Exact when both factors are exactly representable,
+// which covers every hand-written number in the game data; other inputs may
+// be one unit in the last place off.
+double scale(std::uint64_t mantissa, int exponent) {
+    if (mantissa == 0) return 0.0;
+    const auto value = static_cast<double>(mantissa);
+    if (mantissa <= kMaxExactMantissa && exponent >= -kMaxExactPow10 && exponent <= kMaxExactPow10) {
+        return exponent < 0 ? value / kPow10[-exponent] : value * kPow10[exponent];
+    }
+    return value * std::pow(10.0, exponent);
+}
+
+} // namespace
+
+// ---- JsonReader ----
+
+JsonError JsonReader::error(const std::string& message) const {
+    // Only computed on failure, so the scanning loops never track lines.
+    const std::size_t pos = std::min(m_pos, m_text.size());
+    const std::size_t line = 1 + static_cast<std::size_t>(std::count(m_text.begin(), m_text.begin() + pos, '\n'));
+    const std::size_t lineStart = m_text.rfind('\n', pos == 0 ? 0 : pos - 1);
+    const std::size_t column = lineStart == std::string_view::npos || pos == 0 ? pos + 1 : pos - lineStart;
+    return JsonError(std::to_string(line) + ":" + std::to_string(column) + ": " + message, line, column);
+}
+
+void JsonReader::skipWhitespace() {
+    while (m_pos < m_text.size()) {
+        const char c = m_text[m_pos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') return;
+        ++m_pos;
+    }
+}
+
+JsonReader::Event JsonReader::next() {
+    skipWhitespace();
+    switch (m_state) {
+        case State::Done:
+            return Event::End;
+        case State::AfterValue:
+            if (m_stack.empty()) {
+                if (m_pos != m_text.size()) throw error("unexpected characters after the document");
+                m_state = State::Done;
+                return Event::End;
+            }
+            if (m_pos < m_text.size() && m_text[m_pos] == ',') {
+                ++m_pos;
+                skipWhitespace();
+                m_state = m_stack.back() == '{' ? State::Key : State::Value;
+                return next();
+            }
+            if (m_pos < m_text.size() && m_text[m_pos] == (m_stack.back() == '{' ? '}' : ']')) return close();
+            throw error(m_stack.back() == '{' ? "expected ',' or '}'" : "expected ',' or ']'");
+        case State::KeyOrEnd:
+            if (m_pos < m_text.size() && m_text[m_pos] == '}') return close();
+            [[fallthrough]];
+        case State::Key:
+            if (m_pos >= m_text.size() || m_text[m_pos] != '"') throw error("expected a string key");
+            readString();
+            skipWhitespace();
+            if (m_pos >= m_text.size() || m_text[m_pos] != ':') throw error("expected ':'");
+            ++m_pos;
+            m_state = State::Value;
+            return Event::Key;
+        case State::ValueOrEnd:
+            if (m_pos < m_text.size() && m_text[m_pos] == ']') return close();
+            [[fallthrough]];
+        case State::Value:
+            return readValue();
+    }
+    return Event::End;
+}
+
+void JsonReader::skipValue() {
+    std::size_t depth = 0;
+    do {
+        switch (next()) {
+            case Event::BeginObject:
+            case Event::BeginArray:
+                ++depth;
+                break;
+            case Event::EndObject:
+            case Event::EndArray:
+                --depth;
+                break;
+            case Event::End:
+                return;
+            default:
+                break;
+        }
+    } while (depth > 0);
+}
+
+JsonReader::Event JsonReader::readValue() {
+    if (m_pos >= m_text.size()) throw error("unexpected end of input");
+    const char c = m_text[m_pos];
+    switch (c) {
+        case '{':
+        case '[':
+            return open(c);
+        case '"':
+            readString();
+            m_state = State::AfterValue;
+            return Event::String;
+        case 't':
+            readLiteral("true");
+            m_boolean = true;
+            return Event::Bool;
+        case 'f':
+            readLiteral("false");
+            m_boolean = false;
+            return Event::Bool;
+        case 'n':
+            readLiteral("null");
+            return Event::Null;
+        default:
+            if (c == '-' || isDigit(c)) {
+                readNumber();
+                m_state = State::AfterValue;
+                return Event::Number;
+            }
+            throw error(std::string("unexpected character '") + c + "'");
+    }
+}
+
+JsonReader::Event JsonReader::open(char bracket) {
+    if (m_stack.size() >= kMaxDepth) throw error("nesting deeper than " + std::to_string(kMaxDepth));
+    m_stack.push_back(bracket);
+    ++m_pos;
+    m_state = bracket == '{' ? State::KeyOrEnd : State::ValueOrEnd;
+    return bracket == '{' ? Event::BeginObject : Event::BeginArray;
+}
+
+JsonReader::Event JsonReader::close() {
+    const bool object = m_stack.back() == '{';
+    m_stack.pop_back();
+    ++m_pos;
+    m_state = State::AfterValue;
+    return object ? Event::EndObject : Event::EndArray;
+}
+
+void JsonReader::readLiteral(std::string_view literal) {
+    if (m_text.substr(m_pos, literal.size()) != literal) throw error("invalid literal");
+    m_pos += literal.size();
+    m_state = State::AfterValue;
+}
+
+void JsonReader::readString() {
+    const std::size_t start = ++m_pos; // past the opening quote
+    // Fast path: no escapes, so the string is a view of the input.
+    while (m_pos < m_text.size()) {
+        const char c = m_text[m_pos];
+        if (c == '"') {
+            m_string = m_text.substr(start, m_pos - start);
+            ++m_pos;
+            return;
+        }
+        if (c == '\\') break;
+        if (static_cast<unsigned char>(c) < 0x20) throw error("control character in string");
+        ++m_pos;
+    }
+    if (m_pos >= m_text.size()) throw error("unterminated string");
+
+    m_scratch.assign(m_text.data() + start, m_pos - start);
+    while (m_pos < m_text.size()) {
+        const char c = m_text[m_pos];
+        if (c == '"') {
+            m_string = m_scratch;
+            ++m_pos;
+            return;
+        }
+        if (static_cast<unsigned char>(c) < 0x20) throw error("control character in string");
+        if (c != '\\') {
+            m_scratch.push_back(c);
+            ++m_pos;
+            continue;
+        }
+        if (++m_pos >= m_text.size()) break;
+        const char escape = m_text[m_pos++];
+        switch (escape) {
+            case '"': m_scratch.push_back('"'); break;
+            case '\\': m_scratch.push_back('\\'); break;
+            case '/': m_scratch.push_back('/'); break;
+            case 'b': m_scratch.push_back('\b'); break;
+            case 'f': m_scratch.push_back('\f'); break;
+            case 'n': m_scratch.push_back('\n'); break;
+            case 'r': m_scratch.push_back('\r'); break;
+            case 't': m_scratch.push_back('\t'); break;
+            case 'u': {
+                std::uint32_t codePoint = readHex4();
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                    if (m_text.substr(m_pos, 2) != "\\u") throw error("unpaired surrogate");
+                    m_pos += 2;
+                    const std::uint32_t low = readHex4();
+                    if (low < 0xDC00 || low > 0xDFFF) throw error("unpaired surrogate");
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                    throw error("unpaired surrogate");
+                }
+                appendCodePoint(codePoint);
+                break;
+            }
+            default:
+                --m_pos;
+                throw error("invalid escape sequence");
+        }
+    }
+    throw error("unterminated string");
+}
+
+std::uint32_t JsonReader::readHex4() {
+    if (m_pos + 4 > m_text.size()) throw error("truncated \\u escape");
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i, ++m_pos) {
+        const char c = m_text[m_pos];
+        value <<= 4;
+        if (isDigit(c)) value |= static_cast<std::uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') value |= static_cast<std::uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') value |= static_cast<std::uint32_t>(c - 'A' + 10);
+        else throw error("invalid \\u escape");
+    }
+    return value;
+}
+
+void JsonReader::appendCodePoint(std::uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        m_scratch.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        m_scratch.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        m_scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        m_scratch.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        m_scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        m_scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        m_scratch.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        m_scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        m_scratch.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        m_scratch.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+void JsonReader::readNumber() {
+    const std::size_t size = m_text.size();
+    const bool negative = m_text[m_pos] == '-';
+    if (negative) ++m_pos;
+
+    std::uint64_t mantissa = 0;
+    int digits = 0;   // significant digits kept in mantissa
+    int exponent = 0; // decimal exponent applied to mantissa
+    auto addDigit = [&](char c, bool fraction) {
+        if (digits < kMaxSignificantDigits) {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(c - '0');
+            if (mantissa != 0) ++digits;
+            if (fraction) --exponent;
+        } else if (!fraction) {
+            ++exponent; // integer digit past uint64 precision
+        }
+    };
+
+    if (m_pos >= size || !isDigit(m_text[m_pos])) throw error("invalid number");
+    if (m_text[m_pos] == '0') {
+        ++m_pos;
+        if (m_pos < size && isDigit(m_text[m_pos])) throw error("leading zeros are not allowed");
+    } else {
+        while (m_pos < size && isDigit(m_text[m_pos])) addDigit(m_text[m_pos++], false);
+    }
+    if (m_pos < size && m_text[m_pos] == '.') {
+        ++m_pos;
+        if (m_pos >= size || !isDigit(m_text[m_pos])) throw error("expected a digit after '.'");
+        while (m_pos < size && isDigit(m_text[m_pos])) addDigit(m_text[m_pos++], true);
+    }
+    if (m_pos < size && (m_text[m_pos] == 'e' || m_text[m_pos] == 'E')) {
+        ++m_pos;
+        bool negativeExponent = false;
+        if (m_pos < size && (m_text[m_pos] == '+' || m_text[m_pos] == '-')) negativeExponent = m_text[m_pos++] == '-';
+        if (m_pos >= size || !isDigit(m_text[m_pos])) throw error("expected a digit in the exponent");
+        int written = 0;
+        while (m_pos < size && isDigit(m_text[m_pos])) {
+            written = std::min(kExponentLimit, written * 10 + (m_text[m_pos++] - '0'));
+        }
+        exponent += negativeExponent ? -written : written;
+    }
+    const double magnitude = scale(mantissa, exponent);
+    m_number = negative ? -magnitude : magnitude;
+}
+
+// ---- JsonValue ----
+
+const JsonValue* JsonValue::find(std::string_view key) const {
+    if (!is_object()) return nullptr;
+    // Backwards, so that a repeated key resolves to its last occurrence.
+    for (std::uint32_t i = m_size; i-- > 0;) {
+        if (m_payload.members[i].key == key) return &m_payload.members[i].value;
+    }
+    return nullptr;
+}
+
+const JsonValue& JsonValue::at(std::string_view key) const {
+    if (!is_object()) typeError("object");
+    if (const JsonValue* found = find(key)) return *found;
+    throw JsonError("missing key '" + std::string(key) + "'");
+}
+
+const JsonValue& JsonValue::at(std::size_t index) const {
+    if (!is_array()) typeError("array");
+    if (index >= m_size) {
+        throw JsonError("index " + std::to_string(index) + " out of range for an array of " + std::to_string(m_size));
+    }
+    return m_payload.elements[index];
+}
+
+std::span<const JsonValue> JsonValue::elements() const {
+    if (!is_array()) typeError("array");
+    return {m_payload.elements, m_size};
+}
+
+void JsonValue::typeError(const char* expected) const {
+    static constexpr const char* kNames[] = {"null", "boolean", "number", "string", "array", "object"};
+    throw JsonError(std::string("expected ") + expected + ", found " + kNames[static_cast<int>(m_type)]);
+}
+
+// ---- JsonDocument ----
+
+std::string_view JsonDocument::copyString(std::string_view text) {
+    char* chars = m_arena.allocateArray<char>(text.size());
+    if (!text.empty()) std::memcpy(chars, text.data(), text.size());
+    return {chars, text.size()};
+}
+
+JsonDocument JsonDocument::parse(std::string_view text) {
+    JsonDocument document;
+    JsonReader reader(text);
+
+    // Children of every open container, in order, on one shared stack; a
+    // container's children are copied into the arena when it closes, so each
+    // array or object ends up contiguous.
+    struct Open {
+        std::size_t firstChild;
+        std::string_view key; // under which this container sits in its parent
+    };
+    std::vector<JsonMember> children;
+    std::vector<Open> open;
+    std::string_view key;
+    JsonValue root;
+
+    auto limit = [&](std::size_t count) {
+        if (count > UINT32_MAX) throw reader.error("too many values");
+        return static_cast<std::uint32_t>(count);
+    };
+    auto emit = [&](const JsonValue& value) {
+        if (open.empty()) root = value;
+        else children.push_back({key, value});
+    };
+
+    for (JsonReader::Event event = reader.next(); event != JsonReader::Event::End; event = reader.next()) {
+        JsonValue value;
+        switch (event) {
+            case JsonReader::Event::Key:
+                key = document.copyString(reader.string());
+                continue;
+            case JsonReader::Event::BeginObject:
+            case JsonReader::Event::BeginArray:
+                open.push_back({children.size(), key});
+                key = {};
+                continue;
+            case JsonReader::Event::EndObject: {
+                const std::size_t first = open.back().firstChild;
+                const std::size_t count = children.size() - first;
+                JsonMember* members = document.m_arena.allocateArray<JsonMember>(count);
+                std::copy(children.begin() + static_cast<std::ptrdiff_t>(first), children.end(), members);
+                value.m_type = JsonValue::Type::Object;
+                value.m_size = limit(count);
+                value.m_payload.members = members;
+                break;
+            }
+            case JsonReader::Event::EndArray: {
+                const std::size_t first = open.back().firstChild;
+                const std::size_t count = children.size() - first;
+                JsonValue* elements = document.m_arena.allocateArray<JsonValue>(count);
+                for (std::size_t i = 0; i < count; ++i) elements[i] = children[first + i].value;
+                value.m_type = JsonValue::Type::Array;
+                value.m_size = limit(count);
+                value.m_payload.elements = elements;
+                break;
+            }
+            case JsonReader::Event::String: {
+                const std::string_view text = document.copyString(reader.string());
+                value.m_type = JsonValue::Type::String;
+                value.m_size = limit(text.size());
+                value.m_payload.chars = text.data();
+                break;
+            }
+            case JsonReader::Event::Number:
+                value.m_type = JsonValue::Type::Number;
+                value.m_payload.number = reader.number();
+                break;
+            case JsonReader::Event::Bool:
+                value.m_type = JsonValue::Type::Bool;
+                value.m_payload.boolean = reader.boolean();
+                break;
+            case JsonReader::Event::Null:
+            case JsonReader::Event::End:
+                break;
+        }
+        if (event == JsonReader::Event::EndObject || event == JsonReader::Event::EndArray) {
+            children.resize(open.back().firstChild);
+            key = open.back().key;
+            open.pop_back();
+        }
+        emit(value);
+    }
+
+    JsonValue* stored = document.m_arena.allocateArray<JsonValue>(1);
+    *stored = root;
+    document.m_root = stored;
+    return document;
+}
+
+JsonDocument JsonDocument::parseFile(const std::filesystem::path& path) {
+    TD_TRACE_SCOPE("data", "JsonDocument::parseFile", path.string());
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) throw std::runtime_error("Failed to open JSON file: " + path.string());
+    // One sized read instead of growing a string through stream iterators.
+    std::string text(static_cast<std::size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(text.data(), static_cast<std::streamsize>(text.size()));
+    if (!file) throw std::runtime_error("Failed to read JSON file: " + path.string());
+    try {
+        return parse(text);
+    } catch (const JsonError& e) {
+        throw JsonError(path.string() + ":" + e.what(), e.line(), e.column());
+    }
+}
+
+} // namespace core
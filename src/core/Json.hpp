@@ -0,0 +1,183 @@
+#pragma once
+
+#include "Arena.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace core {
+
+// Parse errors carry the 1-based line and column of the offending character,
+// which what() starts with as "line:column: "; lookup and type errors on a
+// parsed document have neither and report 0.
+class JsonError : public std::runtime_error {
+public:
+    explicit JsonError(const std::string& what, std::size_t line = 0, std::size_t column = 0)
+        : std::runtime_error(what), m_line(line), m_column(column) {}
+
+    std::size_t line() const { return m_line; }
+    std::size_t column() const { return m_column; }
+
+private:
+    std::size_t m_line;
+    std::size_t m_column;
+};
+
+// Pull parser over a caller-owned buffer. Each next() returns one event and
+// validates the structure as it goes; string() and number() describe the
+// event just returned. Nothing is allocated except scratch space for strings
+// with escape sequences, and numbers are parsed without the C locale.
+class JsonReader {
+public:
+    enum class Event { BeginObject, EndObject, BeginArray, EndArray, Key, String, Number, Bool, Null, End };
+
+    static constexpr std::size_t kMaxDepth = 512;
+
+    explicit JsonReader(std::string_view text) : m_text(text) {}
+
+    Event next();
+    // Skips the value that starts with the next event, nested containers included.
+    void skipValue();
+
+    // Valid until the next call to next(): the key or string, unescaped.
+    std::string_view string() const { return m_string; }
+    double number() const { return m_number; }
+    bool boolean() const { return m_boolean; }
+    std::size_t depth() const { return m_stack.size(); }
+
+    JsonError error(const std::string& message) const;
+
+private:
+    enum class State { Value, ValueOrEnd, Key, KeyOrEnd, AfterValue, Done };
+
+    void skipWhitespace();
+    Event readValue();
+    Event open(char bracket);
+    Event close();
+    void readString();
+    void readNumber();
+    void readLiteral(std::string_view literal);
+    void appendCodePoint(std::uint32_t codePoint);
+    std::uint32_t readHex4();
+
+    std::string_view m_text;
+    std::size_t m_pos = 0;
+    State m_state = State::Value;
+    std::vector<char> m_stack; // '{' or '[' per open container
+    std::string_view m_string;
+    std::string m_scratch;
+    double m_number = 0.0;
+    bool m_boolean = false;
+};
+
+struct JsonMember;
+
+// Read-only node of a JsonDocument. The lookup surface mirrors the subset of
+// nlohmann::json the loaders use: at, operator[], contains, value, get<T>,
+// size and range-for over arrays. Object members keep file order and are
+// searched linearly, which beats a tree for the handful of keys game data has.
+class JsonValue {
+public:
+    enum class Type : std::uint8_t { Null, Bool, Number, String, Array, Object };
+
+    Type type() const { return m_type; }
+    bool is_null() const { return m_type == Type::Null; }
+    bool is_boolean() const { return m_type == Type::Bool; }
+    bool is_number() const { return m_type == Type::Number; }
+    bool is_string() const { return m_type == Type::String; }
+    bool is_array() const { return m_type == Type::Array; }
+    bool is_object() const { return m_type == Type::Object; }
+    // Elements of an array or members of an object; 0 otherwise.
+    std::size_t size() const { return is_array() || is_object() ? m_size : 0; }
+
+    // nullptr when this is not an object or has no such key.
+    const JsonValue* find(std::string_view key) const;
+    bool contains(std::string_view key) const { return find(key) != nullptr; }
+    const JsonValue& at(std::string_view key) const;
+    const JsonValue& at(std::size_t index) const;
+    const JsonValue& operator[](std::size_t index) const { return at(index); }
+
+    std::span<const JsonValue> elements() const;
+    std::span<const JsonMember> members() const;
+    const JsonValue* begin() const { return elements().data(); }
+    const JsonValue* end() const { return elements().data() + m_size; }
+
+    // Numbers convert to any arithmetic type, strings to std::string or std::string_view.
+    template <typename T>
+    T get() const;
+
+    template <typename T>
+    T value(std::string_view key, T fallback) const {
+        const JsonValue* found = find(key);
+        return found ? found->get<T>() : fallback;
+    }
+
+private:
+    friend class JsonDocument;
+
+    [[noreturn]] void typeError(const char* expected) const;
+
+    Type m_type = Type::Null;
+    std::uint32_t m_size = 0; // string length, element or member count
+    union {
+        bool boolean;
+        double number;
+        const char* chars;
+        const JsonValue* elements;
+        const JsonMember* members;
+    } m_payload{};
+};
+
+struct JsonMember {
+    std::string_view key;
+    JsonValue value;
+};
+
+// Owns a parsed tree. Every node, key and string lives in one arena, so a
+// document is a few large allocations however many values it holds.
+class JsonDocument {
+public:
+    static JsonDocument parse(std::string_view text);
+    // Errors are prefixed with the path, e.g. "data/towers.json:12:7: expected ':'".
+    static JsonDocument parseFile(const std::filesystem::path& path);
+
+    const JsonValue& root() const { return *m_root; }
+    // Arena bytes held by the tree.
+    std::size_t memoryUsed() const { return m_arena.used(); }
+
+private:
+    JsonDocument() = default;
+    std::string_view copyString(std::string_view text);
+
+    Arena m_arena;
+    const JsonValue* m_root = nullptr;
+};
+
+inline std::span<const JsonMember> JsonValue::members() const {
+    if (!is_object()) typeError("object");
+    return {m_payload.members, m_size};
+}
+
+template <typename T>
+T JsonValue::get() const {
+    if constexpr (std::is_same_v<T, bool>) {
+        if (!is_boolean()) typeError("boolean");
+        return m_payload.boolean;
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        if (!is_number()) typeError("number");
+        return static_cast<T>(m_payload.number);
+    } else if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>) {
+        if (!is_string()) typeError("string");
+        return T(m_payload.chars, m_size);
+    } else {
+        static_assert(std::is_same_v<T, bool>, "JsonValue::get supports bool, arithmetic and string types");
+    }
+}
+
+} // namespace core
@@ -0,0 +1,242 @@
+#include "LevelCatalog.hpp"
+
+#include "DataLoader.hpp"
+#include "Json.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+namespace core {
+
+namespace {
+
+// The header fields come first in every level file, so a small prefix of the
+// file usually holds all of them; a file that needs more is read in full.
+constexpr std::size_t kHeaderPrefix = 4096;
+
+std::string readFile(const std::filesystem::path& path, std::size_t limit) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) throw std::runtime_error("Failed to open level file: " + path.string());
+    const auto size = static_cast<std::size_t>(file.tellg());
+    std::string text(std::min(size, limit), '\0');
+    file.seekg(0);
+    file.read(text.data(), static_cast<std::streamsize>(text.size()));
+    if (!file) throw std::runtime_error("Failed to read level file: " + path.string());
+    return text;
+}
+
+int readInt(JsonReader& reader) {
+    if (reader.next() != JsonReader::Event::Number) throw reader.error("expected a number");
+    return static_cast<int>(reader.number());
+}
+
+std::string readString(JsonReader& reader) {
+    if (reader.next() != JsonReader::Event::String) throw reader.error("expected a string");
+    return std::string(reader.string());
+}
+
+// Reads top-level keys until id, name, biome and grid have all been seen and
+// skips everything else, leaving the rest of the text unparsed.
+data::LevelHeader parseHeader(std::string_view text) {
+    JsonReader reader(text);
+    if (reader.next() != JsonReader::Event::BeginObject) throw reader.error("expected a level object");
+    data::LevelHeader header;
+    unsigned found = 0;
+    constexpr unsigned kId = 1, kName = 2, kBiome = 4, kGrid = 8, kAll = 15;
+    while (found != kAll) {
+        if (reader.next() == JsonReader::Event::EndObject) {
+            throw reader.error("level is missing one of id, name, biome and grid");
+        }
+        const std::string_view key = reader.string();
+        if (key == "id") {
+            header.id = readString(reader);
+            found |= kId;
+        } else if (key == "name") {
+            header.name = readString(reader);
+            found |= kName;
+        } else if (key == "biome") {
+            header.biome = readString(reader);
+            found |= kBiome;
+        } else if (key == "grid") {
+            if (reader.next() != JsonReader::Event::BeginObject) throw reader.error("expected a grid object");
+            while (reader.next() != JsonReader::Event::EndObject) {
+                const std::string_view field = reader.string();
+                if (field == "width") header.width = readInt(reader);
+                else if (field == "height") header.height = readInt(reader);
+                else if (field == "tileSize") header.tileSize = readInt(reader);
+                else reader.skipValue();
+            }
+            found |= kGrid;
+        } else {
+            reader.skipValue();
+        }
+    }
+    return header;
+}
+
+data::LevelHeader readHeader(const std::filesystem::path& path) {
+    const std::string prefix = readFile(path, kHeaderPrefix);
+    try {
+        return parseHeader(prefix);
+    } catch (const JsonError& e) {
+        // Real errors and a header cut off by the prefix look alike; the whole file tells them apart.
+        if (prefix.size() < kHeaderPrefix) throw JsonError(path.string() + ":" + e.what(), e.line(), e.column());
+    }
+    try {
+        return parseHeader(readFile(path, std::string::npos));
+    } catch (const JsonError& e) {
+        throw JsonError(path.string() + ":" + e.what(), e.line(), e.column());
+    }
+}
+
+} // namespace
+
+LevelCatalog::LevelCatalog(std::filesystem::path directory, std::size_t capacity)
+    : m_directory(std::move(directory)), m_capacity(std::max<std::size_t>(1, capacity)) {}
+
+LevelCatalog::~LevelCatalog() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [id, entry] : m_resident) entry.pending->abandoned = true;
+    if (m_prefetched.pending) m_prefetched.pending->abandoned = true;
+}
+
+void LevelCatalog::scan() {
+    TD_TRACE_SCOPE("data", "LevelCatalog::scan");
+    std::vector<data::LevelHeader> headers;
+    std::unordered_map<std::string, std::filesystem::path> files;
+    for (const auto& file : DataLoader::findLevelFiles(m_directory)) {
+        try {
+            data::LevelHeader header = readHeader(file);
+            if (!files.emplace(header.id, file).second) {
+                std::cerr << "[LevelCatalog] Skipping " << file << ": level id '" << header.id << "' is taken\n";
+                continue;
+            }
+            headers.push_back(std::move(header));
+        } catch (const std::exception& e) {
+            std::cerr << "[LevelCatalog] Skipping " << e.what() << "\n";
+        }
+    }
+    std::sort(headers.begin(), headers.end(),
+              [](const data::LevelHeader& a, const data::LevelHeader& b) { return a.id < b.id; });
+    m_headers = std::move(headers);
+    m_files = std::move(files);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [id, entry] : m_resident) entry.pending->abandoned = true;
+    m_resident.clear();
+    m_recent.clear();
+    if (m_prefetched.pending) m_prefetched.pending->abandoned = true;
+    m_prefetchedId.clear();
+    m_prefetched = Entry{};
+}
+
+const data::LevelHeader* LevelCatalog::header(const std::string& id) const {
+    auto it = std::lower_bound(m_headers.begin(), m_headers.end(), id,
+                               [](const data::LevelHeader& header, const std::string& key) { return header.id < key; });
+    return it != m_headers.end() && it->id == id ? &*it : nullptr;
+}
+
+const std::filesystem::path* LevelCatalog::file(const std::string& id) const {
+    auto it = m_files.find(id);
+    return it == m_files.end() ? nullptr : &it->second;
+}
+
+std::shared_ptr<const data::LevelDefinition> LevelCatalog::load(const std::string& id) {
+    std::shared_ptr<Pending> pending;
+    std::shared_future<Level> future;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Entry* entry = use(id);
+        if (!entry) return nullptr;
+        pending = entry->pending;
+        future = entry->level;
+    }
+    if (!pending->claimed.exchange(true)) parse(*pending);
+    Level level = future.get();
+    if (!level) {
+        // Forget the failure, so that a fixed file is read again next time.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_resident.find(id);
+        if (it != m_resident.end() && it->second.pending == pending) {
+            m_recent.erase(it->second.recent);
+            m_resident.erase(it);
+        }
+    }
+    return level;
+}
+
+void LevelCatalog::prefetch(const std::string& id) {
+    std::shared_ptr<Pending> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (id == m_prefetchedId || m_resident.count(id)) return;
+        Entry entry;
+        if (!makeEntry(id, entry)) return;
+        if (m_prefetched.pending) m_prefetched.pending->abandoned = true;
+        m_prefetchedId = id;
+        m_prefetched = std::move(entry);
+        pending = m_prefetched.pending;
+    }
+    m_jobs.submit([pending]() {
+        // An abandoned level is left unclaimed, so a load() still holding it parses it itself.
+        if (pending->abandoned || pending->claimed.exchange(true)) return;
+        parse(*pending);
+    });
+}
+
+std::size_t LevelCatalog::residentCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_resident.size();
+}
+
+bool LevelCatalog::makeEntry(const std::string& id, Entry& out) const {
+    auto file = m_files.find(id);
+    if (file == m_files.end()) return false;
+    auto pending = std::make_shared<Pending>();
+    pending->file = file->second;
+    out.level = pending->promise.get_future().share();
+    out.pending = std::move(pending);
+    return true;
+}
+
+LevelCatalog::Entry* LevelCatalog::use(const std::string& id) {
+    auto it = m_resident.find(id);
+    if (it != m_resident.end()) {
+        m_recent.splice(m_recent.begin(), m_recent, it->second.recent);
+        return &it->second;
+    }
+    Entry fresh;
+    if (id == m_prefetchedId) {
+        // Its parse may be running or done already; either way the entry keeps it.
+        fresh = std::move(m_prefetched);
+        m_prefetched = Entry{};
+        m_prefetchedId.clear();
+    } else if (!makeEntry(id, fresh)) {
+        return nullptr;
+    }
+    m_recent.push_front(id);
+    Entry& entry = m_resident[id];
+    entry = std::move(fresh);
+    entry.recent = m_recent.begin();
+    while (m_resident.size() > m_capacity) {
+        auto oldest = m_resident.find(m_recent.back());
+        oldest->second.pending->abandoned = true;
+        m_resident.erase(oldest);
+        m_recent.pop_back();
+    }
+    return &entry;
+}
+
+void LevelCatalog::parse(Pending& pending) {
+    TD_TRACE_SCOPE("data", "LevelCatalog::parse", pending.file.filename().string());
+    try {
+        pending.promise.set_value(std::make_shared<const data::LevelDefinition>(DataLoader::loadLevel(pending.file)));
+    } catch (const std::exception& e) {
+        std::cerr << "[LevelCatalog] Failed to load " << pending.file << ": " << e.what() << "\n";
+        pending.promise.set_value(nullptr);
+    }
+}
+
+} // namespace core
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "GameData.hpp"
+#include "JobSystem.hpp"
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace core {
+
+// The levels in one directory, discovered by scanning it rather than listed
+// anywhere. scan() parses only the header of each file (id, name, biome and
+// grid size) and stops reading there; the rest of a level is parsed when
+// load() first asks for it, or ahead of time on a background worker after
+// prefetch(). The most recently loaded levels stay resident up to a fixed
+// count; older ones are dropped, though a caller holding the shared_ptr from
+// load() keeps its level alive. A prefetched level only joins them once load()
+// asks for it, and only the latest prefetch is kept, so hovering over levels
+// never evicts the ones played recently.
+class LevelCatalog {
+public:
+    static constexpr std::size_t kDefaultCapacity = 8;
+
+    explicit LevelCatalog(std::filesystem::path directory, std::size_t capacity = kDefaultCapacity);
+    // Queued prefetches are dropped; one already running is finished first.
+    ~LevelCatalog();
+
+    LevelCatalog(const LevelCatalog&) = delete;
+    LevelCatalog& operator=(const LevelCatalog&) = delete;
+
+    // Replaces the headers and forgets every resident level. Files that cannot
+    // be read are skipped with a warning. Must not overlap any other call.
+    void scan();
+    // Sorted by id.
+    const std::vector<data::LevelHeader>& headers() const { return m_headers; }
+    const data::LevelHeader* header(const std::string& id) const;
+    // The file the level was found in; its name need not match the id.
+    const std::filesystem::path* file(const std::string& id) const;
+
+    // Returns the resident level, waits for a prefetch already parsing it, or
+    // parses it on the calling thread. nullptr for an unknown id or a level
+    // that fails to parse.
+    std::shared_ptr<const data::LevelDefinition> load(const std::string& id);
+    // Queues a background parse unless the level is resident or the latest
+    // prefetch already. Replaces the previous prefetch, which is dropped if
+    // its parse has not started.
+    void prefetch(const std::string& id);
+    // Levels kept by load(); the prefetched one is not counted.
+    std::size_t residentCount() const;
+
+private:
+    using Level = std::shared_ptr<const data::LevelDefinition>;
+
+    // Parsed by whichever of the worker and load() claims it first.
+    struct Pending {
+        std::filesystem::path file;
+        std::promise<Level> promise;
+        std::atomic<bool> claimed{false};
+        std::atomic<bool> abandoned{false}; // evicted before the worker got to it
+    };
+    struct Entry {
+        std::shared_ptr<Pending> pending;
+        std::shared_future<Level> level;
+        std::list<std::string>::iterator recent; // unused for m_prefetched
+    };
+
+    // Caller holds m_mutex. An unparsed entry for `id`; false for an unknown id.
+    bool makeEntry(const std::string& id, Entry& out) const;
+    // Caller holds m_mutex. Returns the resident entry for `id`, taking over
+    // the prefetched one or creating it if needed, and marks it most recently
+    // used; nullptr for an unknown id.
+    Entry* use(const std::string& id);
+    static void parse(Pending& pending);
+
+    std::filesystem::path m_directory;
+    std::size_t m_capacity;
+    std::vector<data::LevelHeader> m_headers;
+    std::unordered_map<std::string, std::filesystem::path> m_files;
+    mutable std::mutex m_mutex; // guards m_resident and m_recent
+    std::unordered_map<std::string, Entry> m_resident;
+    std::list<std::string> m_recent; // most recently used first
+    std::string m_prefetchedId;      // empty when nothing is prefetched
+    Entry m_prefetched;              // outside the LRU until load() uses it
+    // Last member, so its worker is joined before the entries it fills are destroyed.
+    JobSystem m_jobs{1};
+};
+
+} // namespace core
@@ -0,0 +1,201 @@
+#include "Profiler.hpp"
+
+#if TD_PROFILER
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace core {
+
+namespace {
+constexpr std::size_t kRingSize = 4096; // samples per thread between two collections
+thread_local ProfileScope* t_scope = nullptr;
+} // namespace
+
+// Single-producer ring: only the owning thread writes, only the main thread reads.
+// The main thread drains every frame, far more often than a ring can wrap.
+struct Profiler::ThreadBuffer {
+    std::array<ProfileSample, kRingSize> slots{};
+    std::atomic<std::uint64_t> head{0};
+    std::uint64_t readPos = 0;
+    std::uint32_t thread = 0;
+};
+
+Profiler& Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() {
+    m_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now().time_since_epoch())
+                  .count();
+    m_archive.resize(kArchiveSize);
+}
+
+std::int64_t Profiler::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+               .count() -
+           m_epoch;
+}
+
+Profiler::ThreadBuffer& Profiler::threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        m_threads.push_back(std::make_unique<ThreadBuffer>());
+        buffer = m_threads.back().get();
+        buffer->thread = static_cast<std::uint32_t>(m_threads.size() - 1);
+    }
+    return *buffer;
+}
+
+void Profiler::record(const ProfileSample& sample) {
+    ThreadBuffer& buffer = threadBuffer();
+    const std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    ProfileSample& slot = buffer.slots[head % kRingSize];
+    slot = sample;
+    slot.frame = frameIndex();
+    slot.thread = buffer.thread;
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::beginFrame() {
+    m_frameBegin = now();
+    m_frameBeginAllocations = threadAllocations();
+}
+
+void Profiler::endFrame() {
+    m_lastFrameMs = static_cast<float>(now() - m_frameBegin) / 1e6f;
+    const AllocationCounters allocations = threadAllocations();
+    m_lastFrameAllocations = {allocations.count - m_frameBeginAllocations.count,
+                              allocations.bytes - m_frameBeginAllocations.bytes};
+    m_frameTimes[m_frameCursor] = m_lastFrameMs;
+    m_frameCursor = (m_frameCursor + 1) % kFrameHistory;
+    collect();
+    m_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Profiler::collect() {
+    m_scratch.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        for (auto& buffer : m_threads) {
+            const std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+            std::uint64_t start = std::max(buffer->readPos, head > kRingSize ? head - kRingSize : 0);
+            for (; start < head; ++start) {
+                m_scratch.push_back(buffer->slots[start % kRingSize]);
+            }
+            buffer->readPos = head;
+        }
+    }
+
+    for (auto& stats : m_scopes) {
+        stats.lastMs = 0.f;
+        stats.calls = 0;
+        stats.allocations = 0;
+        stats.selfAllocations = 0;
+        stats.allocatedBytes = 0;
+    }
+    for (const auto& sample : m_scratch) {
+        auto it = std::find_if(m_scopes.begin(), m_scopes.end(),
+                               [&](const ProfileScopeStats& stats) { return stats.name == sample.name; });
+        if (it == m_scopes.end()) {
+            m_scopes.push_back(ProfileScopeStats{});
+            it = m_scopes.end() - 1;
+            it->name = sample.name;
+        }
+        it->lastMs += static_cast<float>(sample.endNs - sample.beginNs) / 1e6f;
+        ++it->calls;
+        it->allocations += sample.allocations;
+        it->selfAllocations += sample.selfAllocations;
+        it->allocatedBytes += sample.allocatedBytes;
+
+        m_archive[m_archiveCursor] = sample;
+        m_archiveCursor = (m_archiveCursor + 1) % kArchiveSize;
+    }
+    for (auto& stats : m_scopes) {
+        stats.history[m_historyCursor] = stats.lastMs;
+        float sum = 0.f;
+        float peak = 0.f;
+        for (float ms : stats.history) {
+            sum += ms;
+            peak = std::max(peak, ms);
+        }
+        stats.averageMs = sum / static_cast<float>(ProfileScopeStats::kHistory);
+        stats.maxMs = peak;
+        stats.averageSelfAllocations =
+            stats.averageSelfAllocations * 0.95f + static_cast<float>(stats.selfAllocations) * 0.05f;
+    }
+    m_historyCursor = (m_historyCursor + 1) % ProfileScopeStats::kHistory;
+}
+
+std::array<float, Profiler::kFrameHistory> Profiler::frameTimes() const {
+    std::array<float, kFrameHistory> ordered{};
+    for (std::size_t i = 0; i < kFrameHistory; ++i) {
+        ordered[i] = m_frameTimes[(m_frameCursor + i) % kFrameHistory];
+    }
+    return ordered;
+}
+
+std::vector<ProfileSample> Profiler::samplesSince(std::uint64_t frame) const {
+    std::vector<ProfileSample> samples;
+    for (std::size_t i = 0; i < kArchiveSize; ++i) {
+        const auto& sample = m_archive[(m_archiveCursor + i) % kArchiveSize];
+        if (sample.name && sample.frame >= frame) samples.push_back(sample);
+    }
+    return samples;
+}
+
+bool Profiler::dumpCsv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "[Profiler] Failed to write " << path << "\n";
+        return false;
+    }
+    file << "frame,thread,depth,name,beginUs,durationUs,allocations,selfAllocations,allocatedBytes\n";
+    for (std::size_t i = 0; i < kArchiveSize; ++i) {
+        const auto& sample = m_archive[(m_archiveCursor + i) % kArchiveSize];
+        if (!sample.name) continue;
+        file << sample.frame << ',' << sample.thread << ',' << sample.depth << ',' << sample.name << ','
+             << static_cast<double>(sample.beginNs) / 1e3 << ','
+             << static_cast<double>(sample.endNs - sample.beginNs) / 1e3 << ',' << sample.allocations << ','
+             << sample.selfAllocations << ',' << sample.allocatedBytes << '\n';
+    }
+    return true;
+}
+
+ProfileScope::ProfileScope(const char* name)
+    : m_name(name),
+      m_begin(Profiler::get().now()),
+      m_depth(t_scope ? t_scope->m_depth + 1 : 0),
+      m_beginAllocations(threadAllocations()),
+      m_previousTag(setAllocationTag(name)),
+      m_parent(t_scope) {
+    t_scope = this;
+}
+
+ProfileScope::~ProfileScope() {
+    const std::int64_t end = Profiler::get().now();
+    const AllocationCounters allocations = threadAllocations();
+    t_scope = m_parent;
+    setAllocationTag(m_previousTag);
+
+    ProfileSample sample;
+    sample.name = m_name;
+    sample.beginNs = m_begin;
+    sample.endNs = end;
+    sample.depth = m_depth;
+    const std::uint64_t inclusive = allocations.count - m_beginAllocations.count;
+    sample.allocations = static_cast<std::uint32_t>(inclusive);
+    sample.selfAllocations = static_cast<std::uint32_t>(inclusive - m_childAllocations);
+    sample.allocatedBytes = allocations.bytes - m_beginAllocations.bytes;
+    if (m_parent) m_parent->m_childAllocations += inclusive;
+    Profiler::get().record(sample);
+}
+
+} // namespace core
+
+#endif
@@ -0,0 +1,138 @@
+#pragma once
+
+// Scoped frame profiler. Enabled by the TOWERDEFENSE_PROFILER CMake option in
+// non-Release builds; otherwise TD_PROFILE_SCOPE expands to nothing and none of
+// the classes below exist.
+
+#ifndef TD_PROFILER
+#define TD_PROFILER 0
+#endif
+
+#if TD_PROFILER
+
+#include "Allocation.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace core {
+
+struct ProfileSample {
+    const char* name = nullptr; // static string, compared by address
+    std::uint64_t frame = 0;
+    std::int64_t beginNs = 0;
+    std::int64_t endNs = 0;
+    std::uint32_t thread = 0;
+    std::uint32_t depth = 0;
+    std::uint32_t allocations = 0;     // including nested scopes
+    std::uint32_t selfAllocations = 0; // excluding nested scopes
+    std::uint64_t allocatedBytes = 0;  // including nested scopes
+};
+
+// Rolling statistics for one scope name, in milliseconds per frame.
+struct ProfileScopeStats {
+    static constexpr std::size_t kHistory = 120;
+
+    const char* name = nullptr;
+    std::array<float, kHistory> history{};
+    float lastMs = 0.f;
+    float averageMs = 0.f;
+    float maxMs = 0.f;
+    std::uint32_t calls = 0; // during the last frame
+    std::uint32_t allocations = 0;
+    std::uint32_t selfAllocations = 0;
+    std::uint64_t allocatedBytes = 0;
+    float averageSelfAllocations = 0.f;
+};
+
+class Profiler {
+public:
+    static constexpr std::size_t kFrameHistory = 240;
+    static constexpr std::size_t kArchiveSize = 1 << 16;
+
+    static Profiler& get();
+
+    // Main thread, once per frame, around everything that should be attributed to it.
+    void beginFrame();
+    void endFrame();
+
+    // Called by ProfileScope; safe from any thread and never blocks after the
+    // thread's first sample.
+    void record(const ProfileSample& sample);
+
+    std::int64_t now() const;
+    std::uint64_t frameIndex() const { return m_frame.load(std::memory_order_relaxed); }
+
+    const std::vector<ProfileScopeStats>& scopes() const { return m_scopes; }
+    // Oldest first.
+    std::array<float, kFrameHistory> frameTimes() const;
+    float lastFrameMs() const { return m_lastFrameMs; }
+    // Main-thread allocations between the last beginFrame/endFrame pair.
+    const AllocationCounters& lastFrameAllocations() const { return m_lastFrameAllocations; }
+
+    // Archived samples from `frame` onwards, oldest first.
+    std::vector<ProfileSample> samplesSince(std::uint64_t frame) const;
+
+    // Raw samples of the most recent frames (up to kArchiveSize), one row each.
+    bool dumpCsv(const std::string& path) const;
+
+private:
+    struct ThreadBuffer;
+
+    Profiler();
+    ThreadBuffer& threadBuffer();
+    void collect();
+
+    std::int64_t m_epoch = 0;
+    std::atomic<std::uint64_t> m_frame{0};
+    std::int64_t m_frameBegin = 0;
+    AllocationCounters m_frameBeginAllocations;
+    AllocationCounters m_lastFrameAllocations;
+
+    std::mutex m_threadsMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+
+    std::vector<ProfileScopeStats> m_scopes;
+    std::array<float, kFrameHistory> m_frameTimes{};
+    std::size_t m_frameCursor = 0;
+    float m_lastFrameMs = 0.f;
+    std::size_t m_historyCursor = 0;
+
+    std::vector<ProfileSample> m_archive;
+    std::size_t m_archiveCursor = 0;
+    std::vector<ProfileSample> m_scratch;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    std::int64_t m_begin;
+    std::uint32_t m_depth;
+    AllocationCounters m_beginAllocations;
+    std::uint64_t m_childAllocations = 0;
+    const char* m_previousTag;
+    ProfileScope* m_parent;
+};
+
+} // namespace core
+
+#define TD_PROFILE_CONCAT_INNER(a, b) a##b
+#define TD_PROFILE_CONCAT(a, b) TD_PROFILE_CONCAT_INNER(a, b)
+#define TD_PROFILE_SCOPE(name) ::core::ProfileScope TD_PROFILE_CONCAT(tdProfileScope, __LINE__)(name)
+
+#else
+
+#define TD_PROFILE_SCOPE(name) ((void)0)
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "GameState.hpp"
+#include "../levels/LevelLoader.hpp"
+#include "../render/RenderList.hpp"
+#include "../ui/HUD.hpp"
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace core {
+
+// Everything the render thread needs for one frame, written by the simulation
+// thread at the end of each tick and handed over through a TripleBuffer.
+struct RenderSnapshot {
+    std::uint64_t tick = 0;
+    GameState state = GameState::MainMenu;
+    // Replaced, not modified, when a level starts; the renderer rebuilds the tilemap on change.
+    std::shared_ptr<const levels::LevelRuntime> level;
+    sf::View camera;
+    render::RenderList entities;
+    // Particle quads in world space, already culled to the camera.
+    std::vector<sf::Vertex> particles;
+    ui::HudValues hud;
+};
+
+} // namespace core
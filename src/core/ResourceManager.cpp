@@ -1,7 +1,9 @@
 #include "ResourceManager.hpp"
 
+#include "Trace.hpp"
 #include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
 #include <vector>
 
@@ -11,8 +13,18 @@ namespace {
 constexpr unsigned int kGeneratedTextureSize = 64;
 constexpr unsigned int kSilentSampleRate = 22050;
 constexpr unsigned int kSilentDurationMs = 250;
+// Texture bytes uploadPending() hands to the driver per frame, about 1 ms of transfer.
+constexpr std::size_t kUploadBytesPerFrame = 4u * 1024u * 1024u;
 } // namespace
 
+ResourceManager::ResourceManager()
+    : m_textureSlots(std::make_unique<TextureSlot[]>(kMaxTextures)),
+      m_soundSlots(std::make_unique<SoundSlot[]>(kMaxSounds)) {
+    generateSilentSound(m_silence);
+}
+
+ResourceManager::~ResourceManager() { m_cancelled = true; }
+
 void ResourceManager::setAssetRoot(std::filesystem::path root) {
     m_assetRoot = std::move(root);
 }
@@ -27,7 +39,7 @@ std::filesystem::path ResourceManager::resolvePath(const std::filesystem::path&
     return m_assetRoot / path;
 }
 
-void ResourceManager::generatePlaceholderTexture(sf::Texture& texture) const {
+sf::Image ResourceManager::placeholderImage() const {
     sf::Image image;
     image.create(kGeneratedTextureSize, kGeneratedTextureSize, sf::Color(160, 160, 160));
     for (unsigned int y = 0; y < kGeneratedTextureSize; ++y) {
@@ -37,10 +49,7 @@ void ResourceManager::generatePlaceholderTexture(sf::Texture& texture) const {
             }
         }
     }
-    if (!texture.loadFromImage(image)) {
-        throw std::runtime_error("Failed to create procedural placeholder texture");
-    }
-    texture.setSmooth(false);
+    return image;
 }
 
 void ResourceManager::generateSilentSound(sf::SoundBuffer& buffer) const {
@@ -51,44 +60,133 @@ void ResourceManager::generateSilentSound(sf::SoundBuffer& buffer) const {
     }
 }
 
-bool ResourceManager::loadTexture(const std::string& id, const std::filesystem::path& path) {
-    auto texture = std::make_unique<sf::Texture>();
+TextureHandle ResourceManager::requestTexture(const std::string& id, const std::filesystem::path& path) {
+    TextureHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto [it, inserted] = m_textureHandles.emplace(id, static_cast<TextureHandle>(m_textureHandles.size()));
+        if (!inserted) return it->second;
+        if (it->second >= kMaxTextures) {
+            m_textureHandles.erase(it);
+            throw std::runtime_error("Too many textures requested, cannot add '" + id + "'");
+        }
+        handle = it->second;
+    }
+    m_jobs.submit([this, handle, id, path]() {
+        if (!m_cancelled) decodeTexture(handle, id, path);
+    });
+    return handle;
+}
+
+SoundHandle ResourceManager::requestSound(const std::string& id, const std::filesystem::path& path) {
+    SoundHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto [it, inserted] = m_soundHandles.emplace(id, static_cast<SoundHandle>(m_soundHandles.size()));
+        if (!inserted) return it->second;
+        if (it->second >= kMaxSounds) {
+            m_soundHandles.erase(it);
+            throw std::runtime_error("Too many sounds requested, cannot add '" + id + "'");
+        }
+        handle = it->second;
+    }
+    m_jobs.submit([this, handle, id, path]() {
+        if (!m_cancelled) decodeSound(handle, id, path);
+    });
+    return handle;
+}
+
+TextureHandle ResourceManager::textureHandle(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_textureHandles.find(id);
+    return it == m_textureHandles.end() ? kInvalidTextureHandle : it->second;
+}
+
+SoundHandle ResourceManager::soundHandle(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_soundHandles.find(id);
+    return it == m_soundHandles.end() ? kInvalidSoundHandle : it->second;
+}
+
+void ResourceManager::decodeTexture(TextureHandle handle, const std::string& id, const std::filesystem::path& path) {
+    TD_TRACE_SCOPE("resource", "decodeTexture", id);
+    sf::Image image;
     const auto resolved = resolvePath(path);
     bool loadedFromFile = false;
     if (!resolved.empty()) {
         std::error_code ec;
         if (std::filesystem::exists(resolved, ec)) {
-            loadedFromFile = texture->loadFromFile(resolved.string());
+            loadedFromFile = image.loadFromFile(resolved.string());
         }
     }
     if (!loadedFromFile) {
-        generatePlaceholderTexture(*texture);
+        image = placeholderImage();
         std::cerr << "[ResourceManager] Using generated texture for '" << id << "' (missing file: " << resolved
                   << ")\n";
-    } else {
-        texture->setSmooth(true);
     }
-    m_textures[id] = std::move(texture);
-    return loadedFromFile;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decodedTextures.push_back({handle, std::move(image), loadedFromFile});
 }
 
-bool ResourceManager::loadSound(const std::string& id, const std::filesystem::path& path) {
-    auto buffer = std::make_unique<sf::SoundBuffer>();
+void ResourceManager::decodeSound(SoundHandle handle, const std::string& id, const std::filesystem::path& path) {
+    TD_TRACE_SCOPE("resource", "decodeSound", id);
     const auto resolved = resolvePath(path);
-    bool loadedFromFile = false;
-    if (!resolved.empty()) {
-        std::error_code ec;
-        if (std::filesystem::exists(resolved, ec)) {
-            loadedFromFile = buffer->loadFromFile(resolved.string());
-        }
-    }
-    if (!loadedFromFile) {
-        generateSilentSound(*buffer);
+    std::error_code ec;
+    if (resolved.empty() || !std::filesystem::exists(resolved, ec)) {
         std::cerr << "[ResourceManager] Using generated silent sound for '" << id << "' (missing file: " << resolved
                   << ")\n";
+        return;
+    }
+    SoundSlot& slot = m_soundSlots[handle];
+    if (!slot.buffer.loadFromFile(resolved.string())) {
+        std::cerr << "[ResourceManager] Using generated silent sound for '" << id << "' (unreadable file: "
+                  << resolved << ")\n";
+        return;
+    }
+    slot.ready.store(true, std::memory_order_release);
+}
+
+void ResourceManager::uploadPending() {
+    if (m_placeholder.getSize().x == 0) {
+        if (!m_placeholder.loadFromImage(placeholderImage())) {
+            throw std::runtime_error("Failed to create procedural placeholder texture");
+        }
+        m_placeholder.setSmooth(false);
+    }
+    std::vector<DecodedTexture> decoded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_decodedTextures.empty()) return;
+        // Oldest first, stopping once the budget is spent; the rest waits for the next frame.
+        std::size_t bytes = 0;
+        std::size_t count = 0;
+        while (count < m_decodedTextures.size() && (count == 0 || bytes < kUploadBytesPerFrame)) {
+            const sf::Vector2u size = m_decodedTextures[count].image.getSize();
+            bytes += static_cast<std::size_t>(size.x) * size.y * 4;
+            ++count;
+        }
+        const auto end = m_decodedTextures.begin() + static_cast<std::ptrdiff_t>(count);
+        decoded.assign(std::make_move_iterator(m_decodedTextures.begin()), std::make_move_iterator(end));
+        m_decodedTextures.erase(m_decodedTextures.begin(), end);
+    }
+    TD_TRACE_SCOPE("resource", "uploadPending");
+    for (const auto& entry : decoded) {
+        TextureSlot& slot = m_textureSlots[entry.handle];
+        if (!slot.texture.loadFromImage(entry.image)) {
+            std::cerr << "[ResourceManager] Failed to upload texture " << entry.handle << ", keeping the placeholder\n";
+            continue;
+        }
+        slot.texture.setSmooth(entry.smooth);
+        slot.uploaded = true;
     }
-    m_sounds[id] = std::move(buffer);
-    return loadedFromFile;
+}
+
+void ResourceManager::registerAtlasImage(const std::string& id, const std::filesystem::path& path) {
+    m_atlas.add(id, resolvePath(path));
+}
+
+void ResourceManager::buildAtlas(const std::filesystem::path& cacheDirectory) {
+    m_atlas.build(cacheDirectory);
 }
 
 bool ResourceManager::tryLoadFont(sf::Font& font, const std::filesystem::path& path) const {
@@ -131,6 +229,7 @@ std::vector<std::filesystem::path> ResourceManager::fontFallbackCandidates() con
 }
 
 bool ResourceManager::loadFont(const std::string& id, const std::filesystem::path& path) {
+    TD_TRACE_SCOPE("resource", "loadFont", id);
     auto font = std::make_unique<sf::Font>();
     const auto resolved = resolvePath(path);
     if (tryLoadFont(*font, resolved)) {
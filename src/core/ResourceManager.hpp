@@ -1,44 +1,122 @@
 #pragma once
 
+#include "JobSystem.hpp"
+#include "TextureAtlas.hpp"
 #include <SFML/Audio.hpp>
 #include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace core {
 
+using TextureHandle = std::uint32_t;
+constexpr TextureHandle kInvalidTextureHandle = ~TextureHandle{0};
+using SoundHandle = std::uint32_t;
+constexpr SoundHandle kInvalidSoundHandle = ~SoundHandle{0};
+
+// Textures and sounds stream in the background: request*() returns a handle
+// right away and a worker reads and decodes the file. Until it is ready a
+// handle resolves to the procedural placeholder (checkerboard texture, silent
+// sound), so callers never wait and never check. Handles index fixed-size slot
+// arrays, which never move, so lookups are O(1) and need no lock.
 class ResourceManager {
 public:
+    static constexpr std::size_t kMaxTextures = 256;
+    static constexpr std::size_t kMaxSounds = 128;
+
+    ResourceManager();
+    // Queued decodes are dropped; one already running is finished first.
+    ~ResourceManager();
+
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+
     void setAssetRoot(std::filesystem::path root);
 
-    bool loadTexture(const std::string& id, const std::filesystem::path& path);
-    bool loadSound(const std::string& id, const std::filesystem::path& path);
-    bool loadFont(const std::string& id, const std::filesystem::path& path);
+    // Any thread. Requesting an id again returns its existing handle.
+    TextureHandle requestTexture(const std::string& id, const std::filesystem::path& path);
+    SoundHandle requestSound(const std::string& id, const std::filesystem::path& path);
+    // kInvalid*Handle when the id was never requested.
+    TextureHandle textureHandle(const std::string& id) const;
+    SoundHandle soundHandle(const std::string& id) const;
 
-    sf::Texture& texture(const std::string& id) { return *m_textures.at(id); }
-    const sf::Texture& texture(const std::string& id) const { return *m_textures.at(id); }
+    // Render thread, once per frame before drawing: creates the placeholder on
+    // the first call, then turns decoded images into textures, a few
+    // megabytes' worth per frame so a burst of finished decodes cannot stall it.
+    void uploadPending();
 
-    sf::SoundBuffer& sound(const std::string& id) { return *m_sounds.at(id); }
-    const sf::SoundBuffer& sound(const std::string& id) const { return *m_sounds.at(id); }
+    // Render thread. The placeholder until the texture has been uploaded.
+    const sf::Texture& texture(TextureHandle handle) const {
+        return textureReady(handle) ? m_textureSlots[handle].texture : m_placeholder;
+    }
+    bool textureReady(TextureHandle handle) const {
+        return handle < kMaxTextures && m_textureSlots[handle].uploaded;
+    }
 
+    // Any thread. Silence until the sound has been decoded.
+    const sf::SoundBuffer& sound(SoundHandle handle) const {
+        if (handle >= kMaxSounds || !m_soundSlots[handle].ready.load(std::memory_order_acquire)) return m_silence;
+        return m_soundSlots[handle].buffer;
+    }
+
+    // Fonts load synchronously: the main menu cannot draw its first frame without one.
+    bool loadFont(const std::string& id, const std::filesystem::path& path);
     sf::Font& font(const std::string& id) { return *m_fonts.at(id); }
     const sf::Font& font(const std::string& id) const { return *m_fonts.at(id); }
 
+    // Atlas images are only read by buildAtlas(), which packs every registered
+    // image (or reuses the packed pages cached in cacheDirectory). It is
+    // prepareAtlas() on any thread followed by uploadAtlas(), as for textures.
+    void registerAtlasImage(const std::string& id, const std::filesystem::path& path);
+    void buildAtlas(const std::filesystem::path& cacheDirectory);
+    void prepareAtlas(const std::filesystem::path& cacheDirectory) { m_atlas.prepare(cacheDirectory); }
+    void uploadAtlas() { m_atlas.upload(); }
+    const TextureAtlas& atlas() const { return m_atlas; }
+
 private:
+    struct TextureSlot {
+        sf::Texture texture; // render thread only
+        bool uploaded = false;
+    };
+    struct SoundSlot {
+        sf::SoundBuffer buffer; // written by the worker before `ready` is set
+        std::atomic<bool> ready{false};
+    };
+    struct DecodedTexture {
+        TextureHandle handle;
+        sf::Image image;
+        bool smooth = true; // generated placeholders stay pixel-sharp
+    };
+
     std::filesystem::path resolvePath(const std::filesystem::path& path) const;
+    void decodeTexture(TextureHandle handle, const std::string& id, const std::filesystem::path& path);
+    void decodeSound(SoundHandle handle, const std::string& id, const std::filesystem::path& path);
     bool tryLoadFont(sf::Font& font, const std::filesystem::path& path) const;
     std::vector<std::filesystem::path> fontFallbackCandidates() const;
-    void generatePlaceholderTexture(sf::Texture& texture) const;
+    sf::Image placeholderImage() const;
     void generateSilentSound(sf::SoundBuffer& buffer) const;
 
     std::filesystem::path m_assetRoot;
-    std::map<std::string, std::unique_ptr<sf::Texture>> m_textures;
-    std::map<std::string, std::unique_ptr<sf::SoundBuffer>> m_sounds;
+    std::unique_ptr<TextureSlot[]> m_textureSlots;
+    std::unique_ptr<SoundSlot[]> m_soundSlots;
+    sf::Texture m_placeholder; // created by the first uploadPending()
+    sf::SoundBuffer m_silence;
     std::map<std::string, std::unique_ptr<sf::Font>> m_fonts;
+    TextureAtlas m_atlas;
+    mutable std::mutex m_mutex; // guards the id maps and m_decodedTextures
+    std::unordered_map<std::string, TextureHandle> m_textureHandles; // its size is the next handle
+    std::unordered_map<std::string, SoundHandle> m_soundHandles;
+    std::vector<DecodedTexture> m_decodedTextures;
+    std::atomic<bool> m_cancelled{false};
+    // Last member, so its workers are joined before the slots they write are destroyed.
+    JobSystem m_jobs{2};
 };
 
 } // namespace core
-
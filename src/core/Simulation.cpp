@@ -0,0 +1,263 @@
+#include "Simulation.hpp"
+
+#include "Profiler.hpp"
+#include "Trace.hpp"
+#include "../entities/Entities.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace core {
+
+const char* simulationStageName(SimulationStage stage) {
+    switch (stage) {
+        case SimulationStage::Economy: return "economy";
+        case SimulationStage::Movement: return "movement";
+        case SimulationStage::SpatialIndex: return "spatialIndex";
+        case SimulationStage::Status: return "status";
+        case SimulationStage::Targeting: return "targeting";
+        case SimulationStage::Firing: return "firing";
+        case SimulationStage::Projectiles: return "projectiles";
+        case SimulationStage::Cleanup: return "cleanup";
+        case SimulationStage::Effects: return "effects";
+        case SimulationStage::Waves: return "waves";
+        case SimulationStage::Count: break;
+    }
+    return "unknown";
+}
+
+template <typename Fn>
+void Simulation::runStage(SimulationStage stage, Fn&& fn) {
+    TD_PROFILE_SCOPE(simulationStageName(stage));
+    TD_TRACE_SCOPE("sim", simulationStageName(stage));
+    if (!m_stageTimes) {
+        fn();
+        return;
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    fn();
+    (*m_stageTimes)[static_cast<std::size_t>(stage)] =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+Simulation::Simulation(const data::GameDatabase& database) : m_database(database) {}
+
+bool Simulation::start(const std::string& levelId) {
+    auto it = m_database.levels.find(levelId);
+    if (it == m_database.levels.end()) return false;
+    start(it->second);
+    return true;
+}
+
+void Simulation::start(const data::LevelDefinition& level) {
+    m_levelId = level.id;
+    m_level = levels::buildLevel(level);
+    m_paths.paths = m_level.paths;
+    m_registry = ecs::Registry{};
+    m_projectilePool.available.clear();
+    m_particles.clear();
+    m_enemyOrder.clear();
+    m_grid.clear();
+    m_pendingSpawns.clear();
+    m_outcome = SimulationOutcome::Running;
+    m_lives = level.startLives;
+    m_coins = level.startCoins;
+    m_waveIndex = 0;
+    m_wavesCleared = 0;
+    m_firstLeakWave = 0;
+    m_waveTimer = 2.f;
+    m_waveInProgress = false;
+    m_spawnTimer = 0.f;
+    m_incomeTimer = 0.f;
+    m_elapsed = 0.f;
+    m_autoWaves = true;
+}
+
+int Simulation::waveCount() const {
+    auto waveDataIt = m_database.waves.find(m_levelId);
+    if (waveDataIt == m_database.waves.end()) return 0;
+    return static_cast<int>(waveDataIt->second.waves.size());
+}
+
+float Simulation::waveProgress() const {
+    if (!m_waveInProgress) return m_wavesCleared > 0 ? 1.f : 0.f;
+    auto waveDataIt = m_database.waves.find(m_levelId);
+    if (waveDataIt == m_database.waves.end()) return 0.f;
+    const auto& waves = waveDataIt->second.waves;
+    if (m_waveIndex <= 0 || m_waveIndex > static_cast<int>(waves.size())) return 0.f;
+    int total = 0;
+    for (const auto& spawn : waves[m_waveIndex - 1].enemies) total += spawn.count;
+    if (total <= 0) return 1.f;
+    const int remaining = pendingSpawnCount() + static_cast<int>(m_registry.m_enemyStats.size());
+    return std::clamp(1.f - static_cast<float>(remaining) / static_cast<float>(total), 0.f, 1.f);
+}
+
+int Simulation::pendingSpawnCount() const {
+    int count = 0;
+    for (const auto& spawn : m_pendingSpawns) count += spawn.count;
+    return count;
+}
+
+void Simulation::tick(float dt) {
+    TD_PROFILE_SCOPE("Simulation::tick");
+    TD_TRACE_SCOPE("sim", "Simulation::tick");
+    if (m_stageTimes) m_stageTimes->fill(0.0);
+    if (m_outcome != SimulationOutcome::Running) return;
+    m_elapsed += dt;
+    runStage(SimulationStage::Economy, [&]() { updateEconomy(dt); });
+    int livesLost = 0;
+    runStage(SimulationStage::Movement, [&]() {
+        systems::updateMovement(m_registry, m_paths, dt, static_cast<float>(m_level.definition.tileSize), livesLost);
+    });
+    if (livesLost > 0 && m_firstLeakWave == 0) {
+        m_firstLeakWave = m_waveIndex;
+    }
+    m_lives -= livesLost;
+    if (m_lives <= 0) {
+        m_outcome = SimulationOutcome::Defeat;
+        return;
+    }
+
+    runStage(SimulationStage::SpatialIndex, [&]() {
+        m_grid.clear();
+        m_enemyOrder.clear();
+        for (const auto& [entity, stats] : m_registry.m_enemyStats) {
+            indexEnemy(entity);
+        }
+    });
+
+    runStage(SimulationStage::Status, [&]() { systems::updateStatus(m_registry, dt, m_database.balance); });
+    runStage(SimulationStage::Targeting, [&]() { systems::updateTargeting(m_registry, m_grid, m_enemyOrder, dt); });
+    runStage(SimulationStage::Firing, [&]() { systems::updateFiring(m_registry, m_projectilePool, dt, m_database.balance); });
+    runStage(SimulationStage::Projectiles, [&]() { systems::updateProjectiles(m_registry, m_particles, dt, m_database.balance); });
+    runStage(SimulationStage::Cleanup, [&]() { systems::updateCleanup(m_registry, m_projectilePool, m_particles); });
+    runStage(SimulationStage::Effects, [&]() { m_particles.update(dt); });
+
+    if (!m_autoWaves) return;
+    runStage(SimulationStage::Waves, [&]() {
+        if (!m_pendingSpawns.empty()) {
+            m_spawnTimer -= dt;
+            if (m_spawnTimer <= 0.f) {
+                auto spawn = m_pendingSpawns.back();
+                m_pendingSpawns.pop_back();
+                spawnEnemyFromWave(spawn);
+                if (!m_pendingSpawns.empty()) {
+                    m_spawnTimer = spawn.delay;
+                }
+            }
+        } else if (m_waveInProgress && m_registry.m_enemyStats.empty()) {
+            m_waveInProgress = false;
+            ++m_wavesCleared;
+            m_coins += static_cast<int>(m_database.balance.waveClearBonus);
+            if (m_waveIndex >= waveCount()) {
+                m_outcome = SimulationOutcome::Victory;
+            }
+        }
+
+        if (!m_waveInProgress) {
+            m_waveTimer -= dt;
+            if (m_waveTimer <= 0.f) {
+                spawnWave();
+            }
+        }
+    });
+}
+
+void Simulation::refreshTowers() {
+    for (const auto& [entity, stats] : m_registry.m_towerStats) {
+        auto it = m_database.towers.find(stats.id);
+        if (it != m_database.towers.end()) entities::applyTowerDefinition(m_registry, entity, it->second);
+    }
+}
+
+bool Simulation::placeTower(const std::string& towerId, const sf::Vector2f& position) {
+    const float tileSize = static_cast<float>(m_level.definition.tileSize);
+    for (const auto& cell : m_level.definition.buildable) {
+        sf::Vector2f cellCenter = {cell.x * tileSize + tileSize * 0.5f, cell.y * tileSize + tileSize * 0.5f};
+        if (math::distance(cellCenter, position) < tileSize * 0.5f) {
+            return placeTowerAtCell(towerId, cell);
+        }
+    }
+    return false;
+}
+
+bool Simulation::placeTowerAtCell(const std::string& towerId, const sf::Vector2i& cell) {
+    const auto& buildable = m_level.definition.buildable;
+    if (std::find(buildable.begin(), buildable.end(), cell) == buildable.end()) return false;
+    auto towerIt = m_database.towers.find(towerId);
+    if (towerIt == m_database.towers.end()) return false;
+    if (m_coins < towerIt->second.cost) return false;
+    m_coins -= towerIt->second.cost;
+    const float tileSize = static_cast<float>(m_level.definition.tileSize);
+    sf::Vector2f cellCenter = {cell.x * tileSize + tileSize * 0.5f, cell.y * tileSize + tileSize * 0.5f};
+    entities::spawnTower(m_registry, towerIt->second, cellCenter);
+    return true;
+}
+
+bool Simulation::spawnTowerAt(const std::string& towerId, const sf::Vector2f& position) {
+    auto towerIt = m_database.towers.find(towerId);
+    if (towerIt == m_database.towers.end()) return false;
+    entities::spawnTower(m_registry, towerIt->second, position);
+    return true;
+}
+
+void Simulation::spawnEnemies(const std::string& enemyId, int count) {
+    spawnEnemyFromWave(data::WaveSpawn{enemyId, count, 0.f});
+}
+
+void Simulation::spawnWave() {
+    auto waveDataIt = m_database.waves.find(m_levelId);
+    if (waveDataIt == m_database.waves.end()) return;
+    if (m_waveIndex >= static_cast<int>(waveDataIt->second.waves.size())) return;
+    const auto& wave = waveDataIt->second.waves[m_waveIndex];
+    m_pendingSpawns.clear();
+    for (const auto& spawn : wave.enemies) {
+        m_pendingSpawns.push_back(spawn);
+    }
+    std::reverse(m_pendingSpawns.begin(), m_pendingSpawns.end());
+    if (!m_pendingSpawns.empty()) {
+        m_spawnTimer = m_pendingSpawns.back().delay;
+    }
+    m_waveIndex++;
+    m_waveInProgress = true;
+    m_waveTimer = wave.spawnInterval;
+}
+
+void Simulation::spawnEnemyFromWave(const data::WaveSpawn& spawn) {
+    auto enemyDefIt = m_database.enemies.find(spawn.type);
+    if (enemyDefIt == m_database.enemies.end()) return;
+    const auto& balance = m_database.balance;
+    const float hpScale = balance.enemyHpMultiplier * m_modifiers.enemyHp;
+    const float speedScale = balance.enemySpeedMultiplier * m_modifiers.enemySpeed;
+    const float rewardScale = balance.enemyRewardMultiplier * m_modifiers.enemyReward;
+    for (int i = 0; i < spawn.count; ++i) {
+        const int pathIndex = i % static_cast<int>(std::max<std::size_t>(1, m_paths.paths.size()));
+        ecs::Entity entity = entities::spawnEnemy(m_registry, enemyDefIt->second, m_paths.paths[pathIndex]);
+        auto& health = m_registry.m_health[entity];
+        health.maxHp *= hpScale;
+        health.hp = health.maxHp;
+        auto& stats = m_registry.m_enemyStats[entity];
+        stats.pathIndex = pathIndex;
+        stats.speed *= speedScale;
+        stats.reward = static_cast<int>(static_cast<float>(stats.reward) * rewardScale);
+        indexEnemy(entity);
+    }
+}
+
+void Simulation::indexEnemy(ecs::Entity entity) {
+    m_enemyOrder.push_back(entity);
+    m_grid.insert(m_enemyOrder.size() - 1, m_registry.m_transforms[entity].position);
+}
+
+void Simulation::updateEconomy(float dt) {
+    m_incomeTimer += dt;
+    if (m_incomeTimer >= 1.f) {
+        int totalIncome = 0;
+        for (const auto& [entity, eco] : m_registry.m_economy) {
+            totalIncome += static_cast<int>(eco.income);
+        }
+        m_coins += totalIncome;
+        m_incomeTimer = 0.f;
+    }
+}
+
+} // namespace core
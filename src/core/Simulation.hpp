@@ -0,0 +1,138 @@
+#pragma once
+
+#include "GameData.hpp"
+#include "RNG.hpp"
+#include "../ecs/Registry.hpp"
+#include "../systems/Systems.hpp"
+#include "../levels/LevelLoader.hpp"
+#include "../math/SpatialHash.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nlohmann {
+class json;
+} // namespace nlohmann
+
+namespace core {
+
+enum class SimulationOutcome { Running, Victory, Defeat };
+
+// Phases of Simulation::tick, in execution order.
+enum class SimulationStage { Economy, Movement, SpatialIndex, Status, Targeting, Firing, Projectiles, Cleanup, Effects, Waves, Count };
+
+constexpr std::size_t kSimulationStageCount = static_cast<std::size_t>(SimulationStage::Count);
+
+const char* simulationStageName(SimulationStage stage);
+
+// Seconds spent in each stage during the most recent tick.
+using SimulationStageTimes = std::array<double, kSimulationStageCount>;
+
+// Per-run scaling applied on top of the global multipliers in balance.json.
+struct SimulationModifiers {
+    float enemyHp = 1.f;
+    float enemySpeed = 1.f;
+    float enemyReward = 1.f;
+};
+
+// Gameplay state and tick for a single level, with no rendering or input.
+// Several simulations may share one GameDatabase across threads; the database
+// is only ever read.
+class Simulation {
+public:
+    explicit Simulation(const data::GameDatabase& database);
+
+    // Looks the level up in the database; false if it has no such level.
+    bool start(const std::string& levelId);
+    // For levels kept outside the database, e.g. in a LevelCatalog.
+    void start(const data::LevelDefinition& level);
+    void tick(float dt);
+
+    bool placeTower(const std::string& towerId, const sf::Vector2f& position);
+    bool placeTowerAtCell(const std::string& towerId, const sf::Vector2i& cell);
+    // Re-applies the database's tower definitions to every placed tower, e.g.
+    // after the definitions were reloaded. Towers of a removed type keep their stats.
+    void refreshTowers();
+
+    // Stress and replay hooks: no cost, buildable or wave bookkeeping.
+    bool spawnTowerAt(const std::string& towerId, const sf::Vector2f& position);
+    void spawnEnemies(const std::string& enemyId, int count);
+    void setAutoWaves(bool enabled) { m_autoWaves = enabled; }
+    void setLives(int lives) { m_lives = lives; }
+    void setCoins(int coins) { m_coins = coins; }
+
+    // Towers, enemies with their statuses, economy and wave progress (SimulationSnapshot.cpp).
+    // Projectiles in flight are not captured.
+    nlohmann::json snapshot() const;
+    bool restore(const nlohmann::json& state);
+
+    // When set, tick() writes per-stage wall time into `times`.
+    void setStageTimes(SimulationStageTimes* times) { m_stageTimes = times; }
+
+    void setModifiers(const SimulationModifiers& modifiers) { m_modifiers = modifiers; }
+    void seed(std::uint32_t value) { m_rng.seed(value); }
+
+    SimulationOutcome outcome() const { return m_outcome; }
+    int lives() const { return m_lives; }
+    int coins() const { return m_coins; }
+    int waveIndex() const { return m_waveIndex; }
+    int waveCount() const;
+    int wavesCleared() const { return m_wavesCleared; }
+    int firstLeakWave() const { return m_firstLeakWave; }
+    int pendingSpawnCount() const;
+    // Share of the current wave's enemies that have been killed or leaked, 0..1.
+    float waveProgress() const;
+    float elapsed() const { return m_elapsed; }
+    const std::string& levelId() const { return m_levelId; }
+    const levels::LevelRuntime& level() const { return m_level; }
+
+    ecs::Registry& registry() { return m_registry; }
+    const ecs::Registry& registry() const { return m_registry; }
+
+    // Enemies by index into enemyOrder(), positioned as of the last spatial index
+    // stage; enemies spawned since then are indexed at their spawn point.
+    const math::SpatialHashGrid& enemyGrid() const { return m_grid; }
+    const std::vector<ecs::Entity>& enemyOrder() const { return m_enemyOrder; }
+    // Visual only; not part of snapshot() and never read by gameplay.
+    const systems::ParticleSystem& particles() const { return m_particles; }
+
+private:
+    void spawnWave();
+    void spawnEnemyFromWave(const data::WaveSpawn& spawn);
+    void indexEnemy(ecs::Entity entity);
+    void updateEconomy(float dt);
+    template <typename Fn>
+    void runStage(SimulationStage stage, Fn&& fn);
+
+    const data::GameDatabase& m_database;
+    SimulationModifiers m_modifiers;
+    RNG m_rng;
+    SimulationStageTimes* m_stageTimes = nullptr;
+    bool m_autoWaves = true;
+
+    levels::LevelRuntime m_level;
+    std::string m_levelId;
+
+    ecs::Registry m_registry;
+    systems::PathContext m_paths;
+    systems::ProjectilePool m_projectilePool;
+    systems::ParticleSystem m_particles;
+    math::SpatialHashGrid m_grid;
+    std::vector<ecs::Entity> m_enemyOrder;
+
+    SimulationOutcome m_outcome = SimulationOutcome::Running;
+    int m_lives = 20;
+    int m_coins = 0;
+    int m_waveIndex = 0;
+    int m_wavesCleared = 0;
+    int m_firstLeakWave = 0;
+    float m_waveTimer = 0.f;
+    bool m_waveInProgress = false;
+    std::vector<data::WaveSpawn> m_pendingSpawns;
+    float m_spawnTimer = 0.f;
+    float m_incomeTimer = 0.f;
+    float m_elapsed = 0.f;
+};
+
+} // namespace core
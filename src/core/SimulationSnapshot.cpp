@@ -0,0 +1,166 @@
+#include "Simulation.hpp"
+
+#include "../entities/Entities.hpp"
+#include <nlohmann/json.hpp>
+
+namespace core {
+
+using nlohmann::json;
+
+namespace {
+
+json vectorToJson(const sf::Vector2f& v) {
+    return json(json::array_t{json(v.x), json(v.y)});
+}
+
+sf::Vector2f vectorFromJson(const json& j) {
+    return {j[0].get<float>(), j[1].get<float>()};
+}
+
+} // namespace
+
+json Simulation::snapshot() const {
+    json::array_t pending;
+    for (const auto& spawn : m_pendingSpawns) {
+        pending.push_back(json{{"type", spawn.type}, {"count", spawn.count}, {"delay", spawn.delay}});
+    }
+
+    json::array_t towers;
+    for (const auto& [entity, tower] : m_registry.m_towerStats) {
+        const auto transformIt = m_registry.m_transforms.find(entity);
+        if (transformIt == m_registry.m_transforms.end()) continue;
+        towers.push_back(json{{"id", tower.id},
+                              {"position", vectorToJson(transformIt->second.position)},
+                              {"cooldown", tower.cooldown},
+                              {"level", tower.level}});
+    }
+
+    json::array_t enemies;
+    for (const auto& [entity, stats] : m_registry.m_enemyStats) {
+        json::array_t statuses;
+        const auto statusIt = m_registry.m_statusContainers.find(entity);
+        if (statusIt != m_registry.m_statusContainers.end()) {
+            for (const auto& status : statusIt->second.active) {
+                statuses.push_back(json{{"id", status.id},
+                                        {"power", status.power},
+                                        {"duration", status.duration},
+                                        {"timeLeft", status.timeLeft},
+                                        {"stacks", status.stacks}});
+            }
+        }
+        const auto healthIt = m_registry.m_health.find(entity);
+        const auto armorIt = m_registry.m_armor.find(entity);
+        const auto resistIt = m_registry.m_magicResist.find(entity);
+        const auto transformIt = m_registry.m_transforms.find(entity);
+        enemies.push_back(json{
+            {"position", vectorToJson(transformIt != m_registry.m_transforms.end() ? transformIt->second.position
+                                                                                    : sf::Vector2f{})},
+            {"hp", healthIt != m_registry.m_health.end() ? healthIt->second.hp : 0.f},
+            {"maxHp", healthIt != m_registry.m_health.end() ? healthIt->second.maxHp : 0.f},
+            {"armor", armorIt != m_registry.m_armor.end() ? armorIt->second.armor : 0.f},
+            {"magicResist", resistIt != m_registry.m_magicResist.end() ? resistIt->second.resist : 0.f},
+            {"speed", stats.speed},
+            {"pathIndex", stats.pathIndex},
+            {"waypoint", stats.waypoint},
+            {"progress", stats.progress},
+            {"reward", stats.reward},
+            {"abilities", stats.abilities},
+            {"flying", stats.flying},
+            {"stealth", stats.stealth},
+            {"stealthTimer", stats.stealthTimer},
+            {"speedModifier", stats.speedModifier},
+            {"dotTimer", stats.dotTimer},
+            {"statuses", json(statuses)}});
+    }
+
+    return json{{"level", m_levelId},
+                {"lives", m_lives},
+                {"coins", m_coins},
+                {"waveIndex", m_waveIndex},
+                {"wavesCleared", m_wavesCleared},
+                {"firstLeakWave", m_firstLeakWave},
+                {"waveTimer", m_waveTimer},
+                {"waveInProgress", m_waveInProgress},
+                {"spawnTimer", m_spawnTimer},
+                {"incomeTimer", m_incomeTimer},
+                {"elapsed", m_elapsed},
+                {"autoWaves", m_autoWaves},
+                {"modifiers", json{{"enemyHp", m_modifiers.enemyHp},
+                                   {"enemySpeed", m_modifiers.enemySpeed},
+                                   {"enemyReward", m_modifiers.enemyReward}}},
+                {"pendingSpawns", json(pending)},
+                {"towers", json(towers)},
+                {"enemies", json(enemies)}};
+}
+
+bool Simulation::restore(const json& state) {
+    if (!start(state.at("level").get<std::string>())) return false;
+    m_lives = state.at("lives").get<int>();
+    m_coins = state.at("coins").get<int>();
+    m_waveIndex = state.at("waveIndex").get<int>();
+    m_wavesCleared = state.value("wavesCleared", 0);
+    m_firstLeakWave = state.value("firstLeakWave", 0);
+    m_waveTimer = state.value("waveTimer", 0.f);
+    m_waveInProgress = state.value("waveInProgress", false);
+    m_spawnTimer = state.value("spawnTimer", 0.f);
+    m_incomeTimer = state.value("incomeTimer", 0.f);
+    m_elapsed = state.value("elapsed", 0.f);
+    m_autoWaves = state.value("autoWaves", true);
+    if (state.contains("modifiers")) {
+        const auto& modifiers = state.at("modifiers");
+        m_modifiers = {modifiers.value("enemyHp", 1.f), modifiers.value("enemySpeed", 1.f),
+                       modifiers.value("enemyReward", 1.f)};
+    }
+    for (const auto& spawn : state.at("pendingSpawns")) {
+        m_pendingSpawns.push_back(data::WaveSpawn{spawn.at("type").get<std::string>(), spawn.at("count").get<int>(),
+                                                  spawn.value("delay", 0.f)});
+    }
+
+    for (const auto& tower : state.at("towers")) {
+        auto towerIt = m_database.towers.find(tower.at("id").get<std::string>());
+        if (towerIt == m_database.towers.end()) continue;
+        ecs::Entity entity =
+            entities::spawnTower(m_registry, towerIt->second, vectorFromJson(tower.at("position")));
+        auto& stats = m_registry.m_towerStats[entity];
+        stats.cooldown = tower.value("cooldown", 0.f);
+        stats.level = tower.value("level", 1);
+    }
+
+    for (const auto& enemy : state.at("enemies")) {
+        ecs::Entity entity = m_registry.create();
+        const sf::Vector2f position = vectorFromJson(enemy.at("position"));
+        m_registry.m_transforms[entity].position = position;
+        auto& renderable = m_registry.m_renderables[entity];
+        renderable.sprite.setColor(sf::Color::Red);
+        renderable.sprite.setPosition(position);
+        m_registry.m_health[entity] = {enemy.at("hp").get<float>(), enemy.at("maxHp").get<float>()};
+        m_registry.m_armor[entity].armor = enemy.value("armor", 0.f);
+        m_registry.m_magicResist[entity].resist = enemy.value("magicResist", 0.f);
+        auto& stats = m_registry.m_enemyStats[entity];
+        stats.speed = enemy.at("speed").get<float>();
+        stats.pathIndex = enemy.value("pathIndex", 0);
+        stats.waypoint = enemy.value("waypoint", 0);
+        stats.progress = enemy.value("progress", 0.f);
+        stats.reward = enemy.value("reward", 0);
+        if (enemy.contains("abilities")) {
+            for (const auto& ability : enemy.at("abilities")) stats.abilities.push_back(ability.get<std::string>());
+        }
+        stats.flying = enemy.value("flying", false);
+        stats.stealth = enemy.value("stealth", false);
+        stats.stealthTimer = enemy.value("stealthTimer", 0.f);
+        stats.speedModifier = enemy.value("speedModifier", 1.f);
+        stats.dotTimer = enemy.value("dotTimer", 0.f);
+        auto& container = m_registry.m_statusContainers[entity];
+        if (enemy.contains("statuses")) {
+            for (const auto& status : enemy.at("statuses")) {
+                container.active.push_back({status.at("id").get<std::string>(), status.value("power", 0.f),
+                                            status.value("duration", 0.f), status.value("timeLeft", 0.f),
+                                            status.value("stacks", 1)});
+            }
+        }
+        indexEnemy(entity);
+    }
+    return true;
+}
+
+} // namespace core
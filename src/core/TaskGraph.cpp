@@ -0,0 +1,81 @@
+#include "TaskGraph.hpp"
+
+#include "Trace.hpp"
+#include <algorithm>
+
+namespace core {
+
+TaskGraph::TaskId TaskGraph::add(std::string name, std::function<void()> work, const std::vector<TaskId>& dependencies) {
+    const TaskId id = m_tasks.size();
+    auto task = std::make_unique<Task>();
+    task->name = std::move(name);
+    task->work = std::move(work);
+    task->waitingOn.store(dependencies.size(), std::memory_order_relaxed);
+    for (TaskId dependency : dependencies) {
+        m_tasks[dependency]->dependents.push_back(id);
+    }
+    m_tasks.push_back(std::move(task));
+    return id;
+}
+
+void TaskGraph::start(JobSystem& jobs) {
+    m_jobs = &jobs;
+    for (TaskId id = 0; id < m_tasks.size(); ++id) {
+        if (m_tasks[id]->waitingOn.load(std::memory_order_relaxed) == 0) submit(id);
+    }
+}
+
+std::string TaskGraph::running() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_running.empty() ? std::string() : m_tasks[m_running.front()]->name;
+}
+
+void TaskGraph::rethrowError() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_error) std::rethrow_exception(m_error);
+}
+
+void TaskGraph::submit(TaskId id) {
+    m_jobs->submit([this, id]() {
+        Task& task = *m_tasks[id];
+        bool skipped;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            skipped = task.skipped;
+            if (!skipped) m_running.push_back(id);
+        }
+        bool failed = skipped;
+        if (!skipped) {
+            TD_TRACE_SCOPE("startup", "task", task.name);
+            try {
+                task.work();
+            } catch (...) {
+                failed = true;
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error) m_error = std::current_exception();
+            }
+        }
+        finish(id, failed);
+    });
+}
+
+void TaskGraph::finish(TaskId id, bool failed) {
+    Task& task = *m_tasks[id];
+    task.work = nullptr; // release captures early
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running.erase(std::remove(m_running.begin(), m_running.end(), id), m_running.end());
+        if (failed) {
+            for (TaskId dependent : task.dependents) m_tasks[dependent]->skipped = true;
+        }
+    }
+    // Dependents go to the queue before this task counts as done, so finished()
+    // never turns true while a task is still to be submitted.
+    for (TaskId dependent : task.dependents) {
+        if (m_tasks[dependent]->waitingOn.fetch_sub(1, std::memory_order_acq_rel) == 1) submit(dependent);
+    }
+    task.done.store(true, std::memory_order_release);
+    m_completed.fetch_add(1, std::memory_order_acq_rel);
+}
+
+} // namespace core
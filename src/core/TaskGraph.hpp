@@ -0,0 +1,59 @@
+#pragma once
+
+#include "JobSystem.hpp"
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace core {
+
+// One-shot set of named tasks with dependencies, run on a JobSystem. A task is
+// submitted as soon as its last dependency finishes, so independent chains
+// overlap. A task that throws is recorded and every task depending on it,
+// directly or not, is skipped. Tasks are added before start(); the graph must
+// outlive the jobs it submitted.
+class TaskGraph {
+public:
+    using TaskId = std::size_t;
+
+    TaskId add(std::string name, std::function<void()> work, const std::vector<TaskId>& dependencies = {});
+    void start(JobSystem& jobs);
+
+    std::size_t size() const { return m_tasks.size(); }
+    std::size_t completed() const { return m_completed.load(std::memory_order_acquire); }
+    bool finished() const { return completed() == m_tasks.size(); }
+    bool done(TaskId id) const { return m_tasks[id]->done.load(std::memory_order_acquire); }
+    // Name of a task that is currently running, or empty.
+    std::string running() const;
+    // Rethrows the first exception a task threw, if any.
+    void rethrowError() const;
+
+private:
+    struct Task {
+        std::string name;
+        std::function<void()> work;
+        std::vector<TaskId> dependents;
+        std::atomic<std::size_t> waitingOn{0};
+        std::atomic<bool> done{false};
+        bool skipped = false;
+    };
+
+    void submit(TaskId id);
+    void finish(TaskId id, bool failed);
+
+    // Heap-allocated so the atomics stay put while tasks are added.
+    std::vector<std::unique_ptr<Task>> m_tasks;
+
+    JobSystem* m_jobs = nullptr;
+    std::atomic<std::size_t> m_completed{0};
+    mutable std::mutex m_mutex; // guards m_running, m_error and Task::skipped
+    std::vector<TaskId> m_running;
+    std::exception_ptr m_error;
+};
+
+} // namespace core
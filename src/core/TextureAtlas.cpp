@@ -0,0 +1,269 @@
+#include "TextureAtlas.hpp"
+
+#include "Hash.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <stdexcept>
+
+namespace core {
+
+using nlohmann::json;
+
+namespace {
+
+constexpr int kCacheVersion = 1;
+constexpr unsigned int kPadding = 1; // edge pixels repeated around each image against filtering bleed
+constexpr unsigned int kPlaceholderSize = 32;
+
+sf::Image placeholderImage(const std::string& id) {
+    // Tinted by id so that placeholder regions can be told apart on screen.
+    const std::uint64_t hash = fnv1a(id);
+    const sf::Color tint(static_cast<sf::Uint8>(96 + (hash & 0x7f)), static_cast<sf::Uint8>(96 + ((hash >> 8) & 0x7f)),
+                         static_cast<sf::Uint8>(96 + ((hash >> 16) & 0x7f)));
+    const sf::Color dark(tint.r * 3 / 4, tint.g * 3 / 4, tint.b * 3 / 4);
+    sf::Image image;
+    image.create(kPlaceholderSize, kPlaceholderSize, tint);
+    for (unsigned int y = 0; y < kPlaceholderSize; ++y) {
+        for (unsigned int x = 0; x < kPlaceholderSize; ++x) {
+            if ((x / 8 + y / 8) % 2 == 0) image.setPixel(x, y, dark);
+        }
+    }
+    return image;
+}
+
+// Copies `image` to (x, y) of `page` and repeats its outermost pixels into the padding.
+void blit(sf::Image& page, const sf::Image& image, unsigned int x, unsigned int y) {
+    page.copy(image, x, y);
+    const sf::Vector2u size = image.getSize();
+    for (unsigned int i = 0; i < size.x; ++i) {
+        page.setPixel(x + i, y - 1, image.getPixel(i, 0));
+        page.setPixel(x + i, y + size.y, image.getPixel(i, size.y - 1));
+    }
+    for (unsigned int j = 0; j < size.y; ++j) {
+        page.setPixel(x - 1, y + j, image.getPixel(0, j));
+        page.setPixel(x + size.x, y + j, image.getPixel(size.x - 1, j));
+    }
+    page.setPixel(x - 1, y - 1, image.getPixel(0, 0));
+    page.setPixel(x + size.x, y - 1, image.getPixel(size.x - 1, 0));
+    page.setPixel(x - 1, y + size.y, image.getPixel(0, size.y - 1));
+    page.setPixel(x + size.x, y + size.y, image.getPixel(size.x - 1, size.y - 1));
+}
+
+std::filesystem::path metadataPath(const std::filesystem::path& directory, const std::string& key) {
+    return directory / ("atlas_" + key + ".json");
+}
+
+std::filesystem::path pagePath(const std::filesystem::path& directory, const std::string& key, std::size_t page) {
+    return directory / ("atlas_" + key + "_" + std::to_string(page) + ".png");
+}
+
+} // namespace
+
+void TextureAtlas::add(const std::string& id, const std::filesystem::path& file) {
+    auto it = m_handles.find(id);
+    if (it != m_handles.end()) {
+        m_sources[it->second].file = file;
+        return;
+    }
+    m_handles.emplace(id, static_cast<AtlasHandle>(m_sources.size()));
+    m_sources.push_back({id, file});
+}
+
+AtlasHandle TextureAtlas::handle(const std::string& id) const {
+    auto it = m_handles.find(id);
+    return it == m_handles.end() ? kInvalidAtlasHandle : it->second;
+}
+
+std::string TextureAtlas::cacheKey() const {
+    std::uint64_t hash = fnv1a("atlas v" + std::to_string(kCacheVersion) + " " + std::to_string(kMaxPageSize));
+    for (const auto& source : m_sources) {
+        hash = fnv1a(source.id, hash);
+        hash = fnv1a("\0", 1, hash);
+        std::ifstream file(source.file, std::ios::binary);
+        if (!file.is_open()) {
+            hash = fnv1a("<missing>", hash);
+            continue;
+        }
+        const std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        hash = fnv1a(bytes, hash);
+    }
+    return hashToHex(hash);
+}
+
+void TextureAtlas::build(const std::filesystem::path& cacheDirectory) {
+    TD_TRACE_SCOPE("resource", "TextureAtlas::build");
+    prepare(cacheDirectory);
+    upload();
+}
+
+void TextureAtlas::prepare(const std::filesystem::path& cacheDirectory) {
+    TD_TRACE_SCOPE("resource", "TextureAtlas::prepare");
+    m_preparedPages.clear();
+    m_regions.assign(m_sources.size(), AtlasRegion{});
+    m_loadedFromCache = false;
+    if (m_sources.empty()) return;
+
+    const std::string key = cacheKey();
+    if (!cacheDirectory.empty() && loadCache(cacheDirectory, key)) {
+        m_loadedFromCache = true;
+        return;
+    }
+    m_preparedPages = pack();
+    if (!cacheDirectory.empty()) saveCache(cacheDirectory, key, m_preparedPages);
+}
+
+void TextureAtlas::upload() {
+    TD_TRACE_SCOPE("resource", "TextureAtlas::upload");
+    m_pages.clear();
+    for (const auto& image : m_preparedPages) {
+        auto texture = std::make_unique<sf::Texture>();
+        if (!texture->loadFromImage(image)) {
+            throw std::runtime_error("Failed to upload texture atlas page");
+        }
+        texture->setSmooth(true);
+        m_pages.push_back(std::move(texture));
+    }
+    m_preparedPages.clear();
+}
+
+std::vector<sf::Image> TextureAtlas::pack() {
+    TD_TRACE_SCOPE("resource", "TextureAtlas::pack");
+    std::vector<sf::Image> images(m_sources.size());
+    std::size_t missing = 0;
+    for (std::size_t i = 0; i < m_sources.size(); ++i) {
+        std::error_code ec;
+        const bool exists = std::filesystem::exists(m_sources[i].file, ec);
+        if (!exists || !images[i].loadFromFile(m_sources[i].file.string())) {
+            images[i] = placeholderImage(m_sources[i].id);
+            ++missing;
+        }
+    }
+    if (missing > 0) {
+        std::cerr << "[TextureAtlas] " << missing << " of " << m_sources.size()
+                  << " images missing, using generated placeholders\n";
+    }
+
+    // Shelf packing, tallest first: each shelf is as tall as its first image.
+    std::vector<std::size_t> order(images.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return images[a].getSize().y > images[b].getSize().y;
+    });
+
+    const unsigned int pageSize = std::min(kMaxPageSize, sf::Texture::getMaximumSize());
+    std::vector<unsigned int> pageHeights;
+    unsigned int cursorX = 0;
+    unsigned int shelfY = 0;
+    unsigned int shelfHeight = 0;
+    for (std::size_t index : order) {
+        const sf::Vector2u size = images[index].getSize();
+        const unsigned int width = size.x + 2 * kPadding;
+        const unsigned int height = size.y + 2 * kPadding;
+        if (width > pageSize || height > pageSize) {
+            throw std::runtime_error("Image '" + m_sources[index].id + "' does not fit in a texture atlas page");
+        }
+        if (pageHeights.empty()) pageHeights.push_back(0);
+        if (cursorX + width > pageSize) {
+            shelfY += shelfHeight;
+            cursorX = 0;
+            shelfHeight = 0;
+        }
+        if (shelfY + height > pageSize) {
+            pageHeights.push_back(0);
+            cursorX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+        AtlasRegion& region = m_regions[index];
+        region.page = pageHeights.size() - 1;
+        region.rect = sf::IntRect(static_cast<int>(cursorX + kPadding), static_cast<int>(shelfY + kPadding),
+                                  static_cast<int>(size.x), static_cast<int>(size.y));
+        cursorX += width;
+        shelfHeight = std::max(shelfHeight, height);
+        pageHeights.back() = std::max(pageHeights.back(), shelfY + shelfHeight);
+    }
+
+    std::vector<sf::Image> pages(pageHeights.size());
+    for (std::size_t page = 0; page < pages.size(); ++page) {
+        pages[page].create(pageSize, pageHeights[page], sf::Color::Transparent);
+    }
+    for (std::size_t i = 0; i < images.size(); ++i) {
+        const sf::IntRect& rect = m_regions[i].rect;
+        blit(pages[m_regions[i].page], images[i], static_cast<unsigned int>(rect.left),
+             static_cast<unsigned int>(rect.top));
+    }
+    return pages;
+}
+
+bool TextureAtlas::loadCache(const std::filesystem::path& directory, const std::string& key) {
+    std::ifstream file(metadataPath(directory, key));
+    if (!file.is_open()) return false;
+    try {
+        const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const json metadata = json::parse(content);
+        if (metadata.at("version").get<int>() != kCacheVersion) return false;
+        const json& regions = metadata.at("regions");
+        const std::size_t pageCount = metadata.at("pages").get<std::size_t>();
+        for (std::size_t i = 0; i < m_sources.size(); ++i) {
+            if (!regions.contains(m_sources[i].id)) return false;
+            const json& entry = regions.at(m_sources[i].id);
+            m_regions[i].page = entry.at("page").get<std::size_t>();
+            m_regions[i].rect = sf::IntRect(entry.at("x").get<int>(), entry.at("y").get<int>(),
+                                            entry.at("w").get<int>(), entry.at("h").get<int>());
+            if (m_regions[i].page >= pageCount) return false;
+        }
+        m_preparedPages.resize(pageCount);
+        for (std::size_t page = 0; page < pageCount; ++page) {
+            if (!m_preparedPages[page].loadFromFile(pagePath(directory, key, page).string())) {
+                m_preparedPages.clear();
+                return false;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[TextureAtlas] Ignoring unreadable cache " << metadataPath(directory, key) << ": " << e.what()
+                  << "\n";
+        m_preparedPages.clear();
+        return false;
+    }
+    return true;
+}
+
+void TextureAtlas::saveCache(const std::filesystem::path& directory, const std::string& key,
+                             const std::vector<sf::Image>& pages) const {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    // Atlases built from an older set of images are never loaded again.
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("atlas_", 0) == 0 && name.rfind("atlas_" + key, 0) != 0) {
+            std::filesystem::remove(entry.path(), ec);
+        }
+    }
+
+    for (std::size_t page = 0; page < pages.size(); ++page) {
+        if (!pages[page].saveToFile(pagePath(directory, key, page).string())) {
+            std::cerr << "[TextureAtlas] Failed to write cache page to " << directory << "\n";
+            return;
+        }
+    }
+    json::object_t regions;
+    for (std::size_t i = 0; i < m_sources.size(); ++i) {
+        const AtlasRegion& region = m_regions[i];
+        regions[m_sources[i].id] = json{{"page", static_cast<int>(region.page)},
+                                        {"x", region.rect.left},
+                                        {"y", region.rect.top},
+                                        {"w", region.rect.width},
+                                        {"h", region.rect.height}};
+    }
+    std::ofstream file(metadataPath(directory, key));
+    file << json{{"version", kCacheVersion}, {"pages", static_cast<int>(pages.size())}, {"regions", json(regions)}}
+                .dump(2)
+         << "\n";
+}
+
+} // namespace core
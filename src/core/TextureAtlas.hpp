@@ -0,0 +1,65 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace core {
+
+using AtlasHandle = std::uint32_t;
+constexpr AtlasHandle kInvalidAtlasHandle = ~AtlasHandle{0};
+
+struct AtlasRegion {
+    std::size_t page = 0;
+    sf::IntRect rect;
+};
+
+// Packs registered images into a few large pages so that everything textured
+// can be drawn with one texture bind per page. The packed pages are cached on
+// disk under a key hashed from the image ids and file contents; an unchanged
+// set of images loads the cached pages instead of decoding and packing again.
+class TextureAtlas {
+public:
+    static constexpr unsigned int kMaxPageSize = 2048;
+
+    // Before build(). Missing files are replaced by a generated placeholder.
+    void add(const std::string& id, const std::filesystem::path& file);
+    // Replaces any previously built pages. An empty cacheDirectory disables the cache.
+    void build(const std::filesystem::path& cacheDirectory);
+    // build() in two steps: prepare() reads, packs and caches the page images
+    // and needs no active OpenGL context, so it can run on a worker thread; upload()
+    // then turns them into textures. Neither may overlap drawing from the atlas.
+    void prepare(const std::filesystem::path& cacheDirectory);
+    void upload();
+
+    AtlasHandle handle(const std::string& id) const;
+    const AtlasRegion& region(AtlasHandle handle) const { return m_regions[handle]; }
+    const sf::Texture& page(std::size_t index) const { return *m_pages[index]; }
+    std::size_t pageCount() const { return m_pages.size(); }
+    bool loadedFromCache() const { return m_loadedFromCache; }
+
+private:
+    struct Source {
+        std::string id;
+        std::filesystem::path file;
+    };
+
+    std::string cacheKey() const;
+    bool loadCache(const std::filesystem::path& directory, const std::string& key);
+    std::vector<sf::Image> pack();
+    void saveCache(const std::filesystem::path& directory, const std::string& key,
+                   const std::vector<sf::Image>& pages) const;
+
+    std::vector<Source> m_sources;
+    std::unordered_map<std::string, AtlasHandle> m_handles;
+    std::vector<AtlasRegion> m_regions;
+    std::vector<std::unique_ptr<sf::Texture>> m_pages;
+    std::vector<sf::Image> m_preparedPages; // between prepare() and upload()
+    bool m_loadedFromCache = false;
+};
+
+} // namespace core
@@ -0,0 +1,120 @@
+#include "ThumbnailCache.hpp"
+
+#include "DataLoader.hpp"
+#include "Hash.hpp"
+#include "Trace.hpp"
+#include "../levels/Tilemap.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace core {
+
+namespace {
+
+// Bump when the thumbnail style or cache key changes so old cache files are not reused.
+constexpr std::uint64_t kThumbnailVersion = 2;
+
+sf::Image renderThumbnail(const data::LevelDefinition& def) {
+    const std::vector<levels::TileKind> tiles = levels::rasterizeTiles(def);
+    sf::Image image;
+    if (tiles.empty()) {
+        image.create(1, 1, levels::tileColor(levels::TileKind::Ground));
+        return image;
+    }
+    // Whole level, aspect preserved, one nearest tile per pixel.
+    const float scale = std::min(static_cast<float>(ThumbnailCache::kMaxWidth) / static_cast<float>(def.width),
+                                 static_cast<float>(ThumbnailCache::kMaxHeight) / static_cast<float>(def.height));
+    const auto width = static_cast<unsigned>(std::max(1.f, std::round(static_cast<float>(def.width) * scale)));
+    const auto height = static_cast<unsigned>(std::max(1.f, std::round(static_cast<float>(def.height) * scale)));
+    image.create(width, height);
+    for (unsigned y = 0; y < height; ++y) {
+        const int tileY = std::min(def.height - 1, static_cast<int>(static_cast<float>(y) / scale));
+        for (unsigned x = 0; x < width; ++x) {
+            const int tileX = std::min(def.width - 1, static_cast<int>(static_cast<float>(x) / scale));
+            image.setPixel(x, y, levels::tileColor(tiles[static_cast<std::size_t>(tileX + tileY * def.width)]));
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+ThumbnailCache::ThumbnailCache(std::filesystem::path cacheDirectory) : m_cacheDirectory(std::move(cacheDirectory)) {}
+
+ThumbnailCache::~ThumbnailCache() { m_cancelled = true; }
+
+void ThumbnailCache::request(const std::string& levelId, const std::filesystem::path& levelFile) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_slots.emplace(levelId, Slot{}).second) return;
+    }
+    m_jobs.submit([this, levelId, levelFile]() {
+        if (!m_cancelled) generate(levelId, levelFile);
+    });
+}
+
+const sf::Texture* ThumbnailCache::texture(const std::string& levelId, bool& failed) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_slots.find(levelId);
+    failed = it != m_slots.end() && it->second.failed;
+    if (it == m_slots.end() || !it->second.ready) return nullptr;
+    Slot& slot = it->second;
+    if (!slot.texture) {
+        slot.texture = std::make_unique<sf::Texture>();
+        if (!slot.texture->loadFromImage(slot.image)) {
+            std::cerr << "[ThumbnailCache] Failed to upload thumbnail for " << levelId << "\n";
+        }
+        slot.image = sf::Image();
+    }
+    return slot.texture.get();
+}
+
+void ThumbnailCache::generate(const std::string& levelId, const std::filesystem::path& levelFile) {
+    TD_TRACE_SCOPE("resource", "ThumbnailCache::generate", levelId);
+    // Size and modification time stand in for the contents, so a cache hit never opens the level file.
+    std::error_code sizeError;
+    std::error_code timeError;
+    const std::uintmax_t size = std::filesystem::file_size(levelFile, sizeError);
+    const auto modified = std::filesystem::last_write_time(levelFile, timeError).time_since_epoch().count();
+    std::uint64_t hash = fnv1a(&kThumbnailVersion, sizeof(kThumbnailVersion));
+    hash = fnv1a(levelFile.filename().string(), hash);
+    hash = fnv1a(&size, sizeof(size), hash);
+    hash = fnv1a(&modified, sizeof(modified), hash);
+    const bool useCache = !sizeError && !timeError && !m_cacheDirectory.empty();
+    const std::string prefix = levelId + "_";
+    const std::filesystem::path cached = m_cacheDirectory / (prefix + hashToHex(hash) + ".png");
+
+    sf::Image image;
+    if (!useCache || !image.loadFromFile(cached.string())) {
+        // Only a cache miss needs the level itself.
+        try {
+            image = renderThumbnail(DataLoader::loadLevel(levelFile));
+        } catch (const std::exception& e) {
+            std::cerr << "[ThumbnailCache] No thumbnail for " << levelId << ": " << e.what() << "\n";
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_slots[levelId].failed = true;
+            return;
+        }
+        if (useCache) {
+            std::error_code ec;
+            std::filesystem::create_directories(m_cacheDirectory, ec);
+            // Thumbnails of earlier versions of this level are never loaded again.
+            for (const auto& entry : std::filesystem::directory_iterator(m_cacheDirectory, ec)) {
+                const std::string name = entry.path().filename().string();
+                const bool ours = name.rfind(prefix, 0) == 0 && name.size() == prefix.size() + 16 + 4;
+                if (ours && entry.path() != cached) std::filesystem::remove(entry.path(), ec);
+            }
+            if (!image.saveToFile(cached.string())) {
+                std::cerr << "[ThumbnailCache] Failed to write " << cached << "\n";
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Slot& slot = m_slots[levelId];
+    slot.image = std::move(image);
+    slot.ready = true;
+}
+
+} // namespace core
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "GameData.hpp"
+#include "JobSystem.hpp"
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace core {
+
+// Level preview images for the level select screen. Thumbnails are generated
+// on a background worker and cached on disk as PNGs keyed by the level file's
+// name, size and modification time, so an unchanged level is decoded from the
+// cache without its file being read at all.
+// Nothing here ever waits for the worker: texture() returns nullptr until the
+// image is ready, and the caller shows a placeholder meanwhile. A level whose
+// thumbnail cannot be made is marked failed, so callers can stop asking.
+class ThumbnailCache {
+public:
+    static constexpr unsigned int kMaxWidth = 96;
+    static constexpr unsigned int kMaxHeight = 54;
+
+    // An empty cacheDirectory disables the disk cache.
+    explicit ThumbnailCache(std::filesystem::path cacheDirectory);
+    // Pending requests are dropped; one already running is finished first.
+    ~ThumbnailCache();
+
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+    // Queues the thumbnail for `levelId`, found in `levelFile`; later requests
+    // for the same id do nothing. The level is parsed only when no cached
+    // thumbnail matches the file.
+    void request(const std::string& levelId, const std::filesystem::path& levelFile);
+    // Render thread: uploads a finished image on first use. `failed` is set
+    // when the thumbnail will never be ready.
+    const sf::Texture* texture(const std::string& levelId, bool& failed);
+
+private:
+    struct Slot {
+        bool ready = false;
+        bool failed = false;
+        sf::Image image;
+        std::unique_ptr<sf::Texture> texture;
+    };
+
+    void generate(const std::string& levelId, const std::filesystem::path& levelFile);
+
+    std::filesystem::path m_cacheDirectory;
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Slot> m_slots;
+    std::atomic<bool> m_cancelled{false};
+    // Last member, so its worker is joined before the slots it writes are destroyed.
+    JobSystem m_jobs{1};
+};
+
+} // namespace core
@@ -0,0 +1,281 @@
+#include "Trace.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace core {
+
+namespace {
+constexpr std::size_t kRingSize = 8192; // events per thread between two writer passes
+constexpr auto kWriterInterval = std::chrono::milliseconds(20);
+
+struct TraceEvent {
+    const char* category = nullptr;
+    const char* name = nullptr;
+    std::int64_t beginNs = 0;
+    std::int64_t endNs = 0;
+    char detail[Trace::kDetailSize] = {};
+};
+
+void appendEscaped(std::string& out, const char* text) {
+    for (; *text; ++text) {
+        const char c = *text;
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            out.push_back(c);
+        }
+    }
+}
+} // namespace
+
+struct Trace::ThreadBuffer {
+    std::array<TraceEvent, kRingSize> events{};
+    std::atomic<std::uint64_t> head{0};
+    std::atomic<std::uint64_t> tail{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<bool> retired{false}; // its thread has exited; no more events arrive
+    const char* emittedName = nullptr; // writer thread only
+    bool drained = false;              // writer thread only: emptied after `retired` was seen
+    std::uint32_t thread = 0;
+};
+
+// Per-thread: the name is kept here so that naming a thread allocates nothing
+// while tracing is off; the ring is only created by the thread's first event.
+struct Trace::ThreadState {
+    const char* name = nullptr;
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadState() {
+        if (buffer) buffer->retired.store(true, std::memory_order_release);
+    }
+};
+
+Trace& Trace::get() {
+    static Trace trace;
+    return trace;
+}
+
+Trace::Trace() {
+    m_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now().time_since_epoch())
+                  .count();
+}
+
+Trace::~Trace() {
+    stop();
+}
+
+std::int64_t Trace::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+               .count() -
+           m_epoch;
+}
+
+bool Trace::startFromEnvironment() {
+    if (const char* path = std::getenv("TOWERDEFENSE_TRACE")) {
+        if (*path) return start(path);
+    }
+    return false;
+}
+
+bool Trace::start(const std::string& path) {
+    if (enabled()) return false;
+    m_file.open(path, std::ios::trunc);
+    if (!m_file.is_open()) {
+        std::cerr << "[Trace] Failed to open " << path << "\n";
+        return false;
+    }
+    m_file << "[\n";
+    m_firstEvent = true;
+    m_stopping = false;
+    // Rings of threads that exited after the last session are empty; the writer is not running yet.
+    releaseRetired(false);
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        for (auto& buffer : m_threads) buffer->dropped.store(0);
+        m_retiredDropped = 0;
+    }
+    m_writer = std::thread([this]() { writerLoop(); });
+    m_enabled.store(true);
+    std::cout << "[Trace] Writing trace events to " << path << "\n";
+    return true;
+}
+
+void Trace::stop() {
+    if (!m_enabled.exchange(false)) return;
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_stopping = true;
+    }
+    m_writerWake.notify_all();
+    m_writer.join();
+    m_file << "\n]\n";
+    m_file.close();
+    std::uint64_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        dropped = m_retiredDropped;
+        for (auto& buffer : m_threads) dropped += buffer->dropped.load();
+    }
+    releaseRetired(false);
+    if (dropped > 0) {
+        std::cerr << "[Trace] Dropped " << dropped << " events (ring buffer full)\n";
+    }
+}
+
+Trace::ThreadState& Trace::threadState() {
+    thread_local ThreadState state;
+    return state;
+}
+
+Trace::ThreadBuffer* Trace::threadBuffer() {
+    ThreadState& state = threadState();
+    if (!state.buffer) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->name.store(state.name, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        buffer->thread = m_nextThread++;
+        state.buffer = buffer.get();
+        m_threads.push_back(std::move(buffer));
+    }
+    return state.buffer;
+}
+
+void Trace::releaseRetired(bool drainedOnly) {
+    std::lock_guard<std::mutex> lock(m_threadsMutex);
+    std::erase_if(m_threads, [this, drainedOnly](const std::unique_ptr<ThreadBuffer>& buffer) {
+        if (drainedOnly ? !buffer->drained : !buffer->retired.load(std::memory_order_acquire)) return false;
+        m_retiredDropped += buffer->dropped.load(std::memory_order_relaxed);
+        return true;
+    });
+}
+
+void Trace::setThreadName(const char* name) {
+    ThreadState& state = threadState();
+    state.name = name;
+    if (state.buffer) state.buffer->name.store(name, std::memory_order_release);
+}
+
+void Trace::record(const char* category, const char* name, const char* detail, std::int64_t beginNs,
+                   std::int64_t endNs) {
+    if (!enabled()) return;
+    ThreadBuffer* buffer = threadBuffer();
+    const std::uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    if (head - buffer->tail.load(std::memory_order_acquire) >= kRingSize) {
+        // The only place a drop is counted.
+        buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    TraceEvent& event = buffer->events[head % kRingSize];
+    event.category = category;
+    event.name = name;
+    event.beginNs = beginNs;
+    event.endNs = endNs;
+    event.detail[0] = '\0';
+    if (detail) {
+        std::strncpy(event.detail, detail, kDetailSize - 1);
+        event.detail[kDetailSize - 1] = '\0';
+    }
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Trace::writerLoop() {
+    setThreadName("trace writer");
+    std::unique_lock<std::mutex> lock(m_writerMutex);
+    while (!m_stopping) {
+        m_writerWake.wait_for(lock, kWriterInterval, [this]() { return m_stopping; });
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+    lock.unlock();
+    flush();
+}
+
+void Trace::flush() {
+    // A ring seen retired here gets no more events, so it can be freed once this pass has drained it.
+    std::vector<std::pair<ThreadBuffer*, bool>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        for (auto& buffer : m_threads) {
+            buffers.emplace_back(buffer.get(), buffer->retired.load(std::memory_order_acquire));
+        }
+    }
+    char number[96];
+    auto separator = [this]() {
+        if (!m_firstEvent) m_pending += ",\n";
+        m_firstEvent = false;
+    };
+    bool anyRetired = false;
+    for (auto [buffer, retired] : buffers) {
+        anyRetired |= retired;
+        const char* name = buffer->name.load(std::memory_order_acquire);
+        if (name && name != buffer->emittedName) {
+            separator();
+            std::snprintf(number, sizeof(number), "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",",
+                          buffer->thread);
+            m_pending += number;
+            m_pending += "\"args\":{\"name\":\"";
+            appendEscaped(m_pending, name);
+            m_pending += "\"}}";
+            buffer->emittedName = name;
+        }
+        std::uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        const std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        for (; tail < head; ++tail) {
+            const TraceEvent& event = buffer->events[tail % kRingSize];
+            separator();
+            m_pending += "{\"ph\":\"X\",\"cat\":\"";
+            appendEscaped(m_pending, event.category);
+            m_pending += "\",\"name\":\"";
+            appendEscaped(m_pending, event.name);
+            std::snprintf(number, sizeof(number), "\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", buffer->thread,
+                          static_cast<double>(event.beginNs) / 1e3,
+                          static_cast<double>(event.endNs - event.beginNs) / 1e3);
+            m_pending += number;
+            if (event.detail[0]) {
+                m_pending += ",\"args\":{\"detail\":\"";
+                appendEscaped(m_pending, event.detail);
+                m_pending += "\"}";
+            }
+            m_pending += "}";
+        }
+        buffer->tail.store(head, std::memory_order_release);
+        buffer->drained = retired;
+    }
+    if (!m_pending.empty()) {
+        m_file << m_pending;
+        m_file.flush();
+        m_pending.clear();
+    }
+    if (anyRetired) releaseRetired(true);
+}
+
+TraceScope::TraceScope(const char* category, const char* name, const char* detail)
+    : m_category(category), m_name(name) {
+    m_detail[0] = '\0';
+    Trace& trace = Trace::get();
+    if (!trace.enabled()) return;
+    if (detail) setDetail(detail);
+    m_begin = trace.now();
+}
+
+void TraceScope::setDetail(const char* detail) {
+    std::strncpy(m_detail, detail, Trace::kDetailSize - 1);
+    m_detail[Trace::kDetailSize - 1] = '\0';
+}
+
+TraceScope::~TraceScope() {
+    if (m_begin < 0) return;
+    Trace& trace = Trace::get();
+    trace.record(m_category, m_name, m_detail[0] ? m_detail : nullptr, m_begin, trace.now());
+}
+
+} // namespace core
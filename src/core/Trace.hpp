@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace core {
+
+// Opt-in timeline tracing in Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Scopes are recorded as complete ("X") events into per-thread single-producer
+// rings and streamed to disk by a background writer thread. When tracing is off
+// a scope costs one relaxed atomic load and no thread owns a ring; a thread's
+// ring is created by its first event and freed after the thread exits and the
+// writer has drained it. When a ring is full the event is dropped rather than
+// blocking the producer.
+class Trace {
+public:
+    static constexpr std::size_t kDetailSize = 48;
+
+    static Trace& get();
+
+    // Starts tracing if TOWERDEFENSE_TRACE names an output file.
+    bool startFromEnvironment();
+    bool start(const std::string& path);
+    void stop();
+
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Names the calling thread in the trace viewer. `name` must be a string literal.
+    void setThreadName(const char* name);
+
+    // `name` and `category` must be string literals; `detail` is copied
+    // (truncated). An event that finds the ring full is counted as dropped.
+    void record(const char* category, const char* name, const char* detail, std::int64_t beginNs, std::int64_t endNs);
+    std::int64_t now() const;
+
+    ~Trace();
+
+private:
+    struct ThreadBuffer;
+    struct ThreadState;
+
+    Trace();
+    static ThreadState& threadState();
+    ThreadBuffer* threadBuffer();
+    // Frees the rings of exited threads: with `drainedOnly`, those the writer
+    // has emptied since they retired, otherwise all (the writer must be stopped).
+    void releaseRetired(bool drainedOnly);
+    void writerLoop();
+    void flush();
+
+    std::int64_t m_epoch = 0;
+    std::atomic<bool> m_enabled{false};
+
+    std::mutex m_threadsMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+    std::uint32_t m_nextThread = 1;      // guarded by m_threadsMutex
+    std::uint64_t m_retiredDropped = 0;  // guarded by m_threadsMutex
+
+    std::mutex m_writerMutex;
+    std::condition_variable m_writerWake;
+    bool m_stopping = false;
+    std::thread m_writer;
+    std::ofstream m_file;
+    std::string m_pending;
+    bool m_firstEvent = true;
+};
+
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name, const char* detail = nullptr);
+    TraceScope(const char* category, const char* name, const std::string& detail)
+        : TraceScope(category, name, detail.c_str()) {}
+    // Used by TD_TRACE_SCOPE: `detail` is only called while the scope is being
+    // recorded, so building a detail string costs nothing when tracing is off.
+    template <typename DetailFn, typename = std::enable_if_t<std::is_invocable_v<DetailFn&>>>
+    TraceScope(const char* category, const char* name, DetailFn&& detail) : TraceScope(category, name) {
+        if (m_begin < 0) return;
+        setDetail(detailText(detail()));
+        // The event starts after the detail is built, as it does for the other constructors.
+        m_begin = Trace::get().now();
+    }
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    static const char* detailText(const char* detail) { return detail; }
+    static const char* detailText(const std::string& detail) { return detail.c_str(); }
+    void setDetail(const char* detail);
+
+    const char* m_category;
+    const char* m_name;
+    std::int64_t m_begin = -1;
+    char m_detail[Trace::kDetailSize];
+};
+
+} // namespace core
+
+#define TD_TRACE_CONCAT_INNER(a, b) a##b
+#define TD_TRACE_CONCAT(a, b) TD_TRACE_CONCAT_INNER(a, b)
+// TD_TRACE_SCOPE(category, name[, detail]); `detail` is evaluated only while tracing is on.
+#define TD_TRACE_SCOPE(category, name, ...)                                                                   \
+    ::core::TraceScope TD_TRACE_CONCAT(tdTraceScope, __LINE__)(                                                \
+        category, name __VA_OPT__(, [&]() -> decltype(auto) { return (__VA_ARGS__); }))
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace core {
+
+// Lock-free hand-off of the latest value from one writer thread to one reader
+// thread. The writer fills back() and publish()es it; the reader's latest()
+// returns the most recently published value and keeps returning it until a
+// newer one arrives. Neither side ever waits for the other, and values are
+// written in place, so their containers keep their capacity.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer thread.
+    T& back() { return m_slots[m_back]; }
+    void publish() {
+        const std::uint8_t previous = m_middle.exchange(static_cast<std::uint8_t>(m_back | kFresh), std::memory_order_acq_rel);
+        m_back = previous & kIndexMask;
+    }
+
+    // Reader thread.
+    const T& latest() {
+        if (m_middle.load(std::memory_order_relaxed) & kFresh) {
+            const std::uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = previous & kIndexMask;
+        }
+        return m_slots[m_front];
+    }
+
+private:
+    static constexpr std::uint8_t kFresh = 0x4;
+    static constexpr std::uint8_t kIndexMask = 0x3;
+
+    std::array<T, 3> m_slots{};
+    std::uint8_t m_back = 0;
+    std::uint8_t m_front = 1;
+    std::atomic<std::uint8_t> m_middle{2};
+};
+
+} // namespace core
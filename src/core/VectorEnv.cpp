@@ -0,0 +1,134 @@
+#include "VectorEnv.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace core {
+
+namespace {
+constexpr std::size_t kScalarCount = 4;
+constexpr float kTerminalReward = 10.f;
+} // namespace
+
+VectorEnv::VectorEnv(const data::GameDatabase& database, std::size_t envCount, VectorEnvConfig config)
+    : m_database(database), m_config(std::move(config)), m_jobs(m_config.threads) {
+    if (envCount == 0) {
+        throw std::invalid_argument("VectorEnv needs at least one environment");
+    }
+    m_config.gridWidth = std::max(1, m_config.gridWidth);
+    m_config.gridHeight = std::max(1, m_config.gridHeight);
+    m_config.maxPaths = std::max(1, m_config.maxPaths);
+    m_config.pathBuckets = std::max(1, m_config.pathBuckets);
+    m_config.ticksPerStep = std::max(1, m_config.ticksPerStep);
+    const std::size_t tileCount = static_cast<std::size_t>(m_config.gridWidth) * m_config.gridHeight;
+    m_observationSize = tileCount + static_cast<std::size_t>(m_config.maxPaths) * m_config.pathBuckets + kScalarCount;
+    m_envs.reserve(envCount);
+    for (std::size_t i = 0; i < envCount; ++i) {
+        auto env = std::make_unique<Env>(m_database);
+        env->tiles.assign(tileCount, 0.f);
+        m_envs.push_back(std::move(env));
+    }
+    m_observations.assign(envCount * m_observationSize, 0.f);
+    m_rewards.assign(envCount, 0.f);
+    m_dones.assign(envCount, 0);
+}
+
+void VectorEnv::reset(const std::vector<std::string>& levelIds) {
+    if (levelIds.size() != 1 && levelIds.size() != m_envs.size()) {
+        throw std::invalid_argument("VectorEnv::reset expects one level id or one per environment");
+    }
+    for (std::size_t i = 0; i < m_envs.size(); ++i) {
+        const auto& levelId = levelIds.size() == 1 ? levelIds.front() : levelIds[i];
+        if (!m_database.levels.count(levelId)) {
+            throw std::invalid_argument("VectorEnv::reset got unknown level: " + levelId);
+        }
+        m_envs[i]->levelId = levelId;
+    }
+    m_jobs.parallelFor(m_envs.size(), [this](std::size_t i) {
+        resetEnv(i);
+        m_rewards[i] = 0.f;
+        m_dones[i] = 0;
+        writeObservation(i);
+    });
+}
+
+void VectorEnv::step(const EnvAction* actions) {
+    m_jobs.parallelFor(m_envs.size(), [this, actions](std::size_t i) { stepEnv(i, actions[i]); });
+}
+
+void VectorEnv::resetEnv(std::size_t index) {
+    auto& env = *m_envs[index];
+    env.sim.start(env.levelId);
+    env.wavesCleared = 0;
+    std::fill(env.tiles.begin(), env.tiles.end(), 0.f);
+    const auto& level = env.sim.level().definition;
+    auto markTile = [&](const sf::Vector2i& cell, float value) {
+        if (cell.x < 0 || cell.y < 0 || cell.x >= m_config.gridWidth || cell.y >= m_config.gridHeight) return;
+        env.tiles[static_cast<std::size_t>(cell.x + cell.y * m_config.gridWidth)] = value;
+    };
+    for (const auto& cell : level.obstacles) markTile(cell, -1.f);
+    for (const auto& cell : level.buildable) markTile(cell, 0.5f);
+}
+
+void VectorEnv::stepEnv(std::size_t index, const EnvAction& action) {
+    auto& env = *m_envs[index];
+    if (m_dones[index]) {
+        resetEnv(index);
+        m_dones[index] = 0;
+    }
+
+    if (action.type == EnvActionType::PlaceTower && action.tower >= 0 &&
+        action.tower < static_cast<std::int32_t>(m_config.towerIds.size()) && action.cell >= 0 &&
+        action.cell < static_cast<std::int32_t>(env.tiles.size())) {
+        const sf::Vector2i cell{action.cell % m_config.gridWidth, action.cell / m_config.gridWidth};
+        if (env.sim.placeTowerAtCell(m_config.towerIds[static_cast<std::size_t>(action.tower)], cell)) {
+            env.tiles[static_cast<std::size_t>(action.cell)] = 1.f;
+        }
+    }
+
+    const int livesBefore = env.sim.lives();
+    const float dt = 1.f / m_config.tickRate;
+    for (int t = 0; t < m_config.ticksPerStep && env.sim.outcome() == SimulationOutcome::Running; ++t) {
+        env.sim.tick(dt);
+    }
+
+    float reward = static_cast<float>(env.sim.wavesCleared() - env.wavesCleared) -
+                   static_cast<float>(livesBefore - std::max(0, env.sim.lives()));
+    env.wavesCleared = env.sim.wavesCleared();
+    const auto outcome = env.sim.outcome();
+    if (outcome == SimulationOutcome::Victory) reward += kTerminalReward;
+    if (outcome == SimulationOutcome::Defeat) reward -= kTerminalReward;
+    m_rewards[index] = reward;
+    m_dones[index] = (outcome != SimulationOutcome::Running || env.sim.elapsed() >= m_config.maxSeconds) ? 1 : 0;
+    writeObservation(index);
+}
+
+void VectorEnv::writeObservation(std::size_t index) {
+    const auto& env = *m_envs[index];
+    float* out = m_observations.data() + index * m_observationSize;
+    std::copy(env.tiles.begin(), env.tiles.end(), out);
+    out += env.tiles.size();
+
+    const std::size_t densityCount = static_cast<std::size_t>(m_config.maxPaths) * m_config.pathBuckets;
+    std::fill(out, out + densityCount, 0.f);
+    const auto& paths = env.sim.level().paths;
+    for (const auto& [entity, stats] : env.sim.registry().m_enemyStats) {
+        if (stats.pathIndex < 0 || stats.pathIndex >= m_config.maxPaths ||
+            stats.pathIndex >= static_cast<int>(paths.size())) {
+            continue;
+        }
+        const auto pointCount = paths[stats.pathIndex].points.size();
+        const float segments = pointCount > 1 ? static_cast<float>(pointCount - 1) : 1.f;
+        const float progress = std::clamp((static_cast<float>(stats.waypoint) + stats.progress) / segments, 0.f, 1.f);
+        const int bucket = std::min(m_config.pathBuckets - 1, static_cast<int>(progress * m_config.pathBuckets));
+        out[stats.pathIndex * m_config.pathBuckets + bucket] += 1.f;
+    }
+    out += densityCount;
+
+    out[0] = static_cast<float>(env.sim.coins());
+    out[1] = static_cast<float>(env.sim.lives());
+    out[2] = static_cast<float>(env.sim.waveIndex());
+    out[3] = static_cast<float>(env.sim.waveCount());
+}
+
+} // namespace core
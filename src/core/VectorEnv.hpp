@@ -0,0 +1,81 @@
+#pragma once
+
+#include "GameData.hpp"
+#include "JobSystem.hpp"
+#include "Simulation.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace core {
+
+enum class EnvActionType : std::int32_t { Noop = 0, PlaceTower = 1 };
+
+struct EnvAction {
+    EnvActionType type = EnvActionType::Noop;
+    std::int32_t tower = 0; // index into VectorEnvConfig::towerIds
+    std::int32_t cell = 0;  // x + y * gridWidth
+};
+
+struct VectorEnvConfig {
+    int gridWidth = 32;
+    int gridHeight = 18;
+    int maxPaths = 4;
+    int pathBuckets = 16;
+    int ticksPerStep = 6;
+    float tickRate = 60.f;
+    float maxSeconds = 900.f;
+    unsigned threads = 0;
+    std::vector<std::string> towerIds{"arrow_mk1"};
+};
+
+// N independent simulations stepped together for automated agents.
+//
+// Observation layout per environment (floats):
+//   [gridWidth * gridHeight]     tile occupancy: -1 obstacle, 0 open, 0.5 buildable, 1 tower
+//   [maxPaths * pathBuckets]     enemies per path bucket, ordered by path progress
+//   [4]                          coins, lives, wave index, wave count
+// Reward per step: waves cleared - lives lost, +10 on victory, -10 on defeat.
+// Environments that finished on the previous step are reset to the same level
+// before their next action is applied.
+class VectorEnv {
+public:
+    VectorEnv(const data::GameDatabase& database, std::size_t envCount, VectorEnvConfig config = {});
+
+    // One level id per environment, or a single id used for all of them.
+    void reset(const std::vector<std::string>& levelIds);
+    // `actions` must hold envCount() entries.
+    void step(const EnvAction* actions);
+
+    std::size_t envCount() const { return m_envs.size(); }
+    std::size_t observationSize() const { return m_observationSize; }
+    const float* observations() const { return m_observations.data(); }
+    const float* rewards() const { return m_rewards.data(); }
+    const std::uint8_t* dones() const { return m_dones.data(); }
+
+private:
+    struct Env {
+        explicit Env(const data::GameDatabase& database) : sim(database) {}
+        Simulation sim;
+        std::string levelId;
+        std::vector<float> tiles;
+        int wavesCleared = 0;
+    };
+
+    void resetEnv(std::size_t index);
+    void stepEnv(std::size_t index, const EnvAction& action);
+    void writeObservation(std::size_t index);
+
+    const data::GameDatabase& m_database;
+    VectorEnvConfig m_config;
+    std::vector<std::unique_ptr<Env>> m_envs;
+    JobSystem m_jobs;
+
+    std::size_t m_observationSize = 0;
+    std::vector<float> m_observations;
+    std::vector<float> m_rewards;
+    std::vector<std::uint8_t> m_dones;
+};
+
+} // namespace core
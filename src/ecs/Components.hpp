@@ -127,7 +127,6 @@ struct BuffAura {
 };
 
 struct ProjectilePoolTag {};
-struct EffectPoolTag {};
 
 } // namespace ecs
 
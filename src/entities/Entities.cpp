@@ -36,8 +36,14 @@ ecs::Entity spawnTower(ecs::Registry& registry, const data::TowerDefinition& def
     ecs::Entity entity = registry.create();
     registry.m_transforms[entity].position = position;
     registry.m_renderables[entity].sprite.setColor(sf::Color::Blue);
+    registry.m_towerStats[entity].id = def.id;
+    applyTowerDefinition(registry, entity, def);
+    registry.m_targeting[entity];
+    return entity;
+}
+
+void applyTowerDefinition(ecs::Registry& registry, ecs::Entity entity, const data::TowerDefinition& def) {
     auto& tower = registry.m_towerStats[entity];
-    tower.id = def.id;
     tower.statusEffect = def.statusEffect;
     tower.damage = def.damage;
     tower.fireRate = def.fireRate;
@@ -51,9 +57,9 @@ ecs::Entity spawnTower(ecs::Registry& registry, const data::TowerDefinition& def
     tower.canHitFlying = def.canHitFlying;
     if (def.income > 0.f) {
         registry.m_economy[entity].income = def.income;
+    } else {
+        registry.m_economy.erase(entity);
     }
-    registry.m_targeting[entity];
-    return entity;
 }
 
 } // namespace entities
@@ -9,6 +9,8 @@ namespace entities {
 
 ecs::Entity spawnEnemy(ecs::Registry& registry, const data::EnemyDefinition& def, const math::Path& path);
 ecs::Entity spawnTower(ecs::Registry& registry, const data::TowerDefinition& def, const sf::Vector2f& position);
+// Sets a tower's combat stats and income from `def`, keeping its cooldown, level and branch choice.
+void applyTowerDefinition(ecs::Registry& registry, ecs::Entity entity, const data::TowerDefinition& def);
 
 }
 
@@ -1,58 +1,438 @@
 #include "Editor.hpp"
 
+#include "../core/Profiler.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
+#include <iostream>
 #include <nlohmann/json.hpp>
 
 namespace levels {
 
+namespace {
+
+// Cycled with G; large presets exercise the chunked renderer.
+const std::array<sf::Vector2i, 4> kGridPresets{{{16, 12}, {64, 64}, {256, 256}, {512, 512}}};
+// Oldest edits are dropped once the history holds more tile changes than this.
+constexpr std::size_t kMaxHistoryChanges = std::size_t{1} << 22;
+constexpr float kPanTiles = 8.f;
+constexpr float kMinZoom = 0.25f;
+constexpr float kMaxZoom = 16.f;
+
+const char* toolName(LevelEditor::Tool tool) {
+    switch (tool) {
+        case LevelEditor::Tool::Brush: return "brush";
+        case LevelEditor::Tool::Rectangle: return "rectangle";
+        case LevelEditor::Tool::Fill: return "fill";
+        case LevelEditor::Tool::Entry: return "entry";
+        case LevelEditor::Tool::Exit: return "exit";
+    }
+    return "";
+}
+
+const char* kindName(TileKind kind) {
+    switch (kind) {
+        case TileKind::Ground: return "ground";
+        case TileKind::Path: return "path";
+        case TileKind::Buildable: return "buildable";
+        case TileKind::Obstacle: return "obstacle";
+    }
+    return "";
+}
+
+void appendQuad(sf::VertexArray& vertices, float left, float top, float size, const sf::Color& color) {
+    vertices.append(sf::Vertex({left, top}, color));
+    vertices.append(sf::Vertex({left + size, top}, color));
+    vertices.append(sf::Vertex({left + size, top + size}, color));
+    vertices.append(sf::Vertex({left, top + size}, color));
+}
+
+} // namespace
+
 void LevelEditor::init(int width, int height, int tileSize, const sf::Font& font) {
-    m_width = width;
-    m_height = height;
     m_tileSize = tileSize;
-    m_data.assign(width * height, 0);
     m_hint.setFont(font);
     m_hint.setCharacterSize(16);
-    m_hint.setString("Level Editor: Left click toggles path/build tiles, press E to export level.json");
-    m_hint.setPosition(40.f, 40.f);
+    m_hint.setString("1-4 ground/path/build/obstacle  B brush  R rectangle  F fill  S entry  X exit  "
+                     "Ctrl+Z/Y undo/redo  G grid size  arrows/wheel view  E export");
+    m_status.setFont(font);
+    m_status.setCharacterSize(16);
+    m_sizePreset = 0;
+    resize(width, height);
+}
+
+void LevelEditor::resize(int width, int height) {
+    m_width = std::max(1, width);
+    m_height = std::max(1, height);
+    m_tiles.assign(static_cast<std::size_t>(m_width * m_height), TileKind::Ground);
+    m_tilemap.build(m_width, m_height, static_cast<float>(m_tileSize));
+    m_changes.clear();
+    m_edits.clear();
+    m_applied = 0;
+    m_editing = false;
+    m_dragging = false;
+    m_entry = m_exit = {-1, -1};
+
+    // Fit the whole grid on screen, anchored to the top-left when it is small.
+    const sf::Vector2f world{static_cast<float>(m_width * m_tileSize), static_cast<float>(m_height * m_tileSize)};
+    m_zoom = std::clamp(std::max(world.x / m_viewport.x, world.y / m_viewport.y), 1.f, kMaxZoom);
+    m_center = m_zoom > 1.f ? world * 0.5f : m_viewport * 0.5f;
+    validate();
 }
 
 void LevelEditor::handleEvent(const sf::Event& event) {
-    if (event.type == sf::Event::MouseButtonPressed) {
-        int x = event.mouseButton.x / m_tileSize;
-        int y = event.mouseButton.y / m_tileSize;
-        if (x >= 0 && x < m_width && y >= 0 && y < m_height) {
-            int index = x + y * m_width;
-            m_data[index] = (m_data[index] + 1) % 3;
+    if (event.type == sf::Event::KeyPressed) {
+        const bool control = event.key.control;
+        switch (event.key.code) {
+            case sf::Keyboard::Num1: m_brush = TileKind::Ground; break;
+            case sf::Keyboard::Num2: m_brush = TileKind::Path; break;
+            case sf::Keyboard::Num3: m_brush = TileKind::Buildable; break;
+            case sf::Keyboard::Num4: m_brush = TileKind::Obstacle; break;
+            case sf::Keyboard::B: m_tool = Tool::Brush; break;
+            case sf::Keyboard::R: m_tool = Tool::Rectangle; break;
+            case sf::Keyboard::F: m_tool = Tool::Fill; break;
+            case sf::Keyboard::S: m_tool = Tool::Entry; break;
+            case sf::Keyboard::X: m_tool = Tool::Exit; break;
+            case sf::Keyboard::Z:
+                if (control && event.key.shift) {
+                    redo();
+                } else if (control) {
+                    undo();
+                }
+                break;
+            case sf::Keyboard::Y:
+                if (control) redo();
+                break;
+            case sf::Keyboard::G: {
+                m_sizePreset = (m_sizePreset + 1) % kGridPresets.size();
+                resize(kGridPresets[m_sizePreset].x, kGridPresets[m_sizePreset].y);
+                break;
+            }
+            case sf::Keyboard::Left: m_center.x -= kPanTiles * m_tileSize * m_zoom; break;
+            case sf::Keyboard::Right: m_center.x += kPanTiles * m_tileSize * m_zoom; break;
+            case sf::Keyboard::Up: m_center.y -= kPanTiles * m_tileSize * m_zoom; break;
+            case sf::Keyboard::Down: m_center.y += kPanTiles * m_tileSize * m_zoom; break;
+            case sf::Keyboard::E: exportJson("editor_export.json"); break;
+            default: break;
         }
+        refreshStatus();
+        return;
+    }
+    if (event.type == sf::Event::MouseWheelScrolled) {
+        m_zoom = std::clamp(m_zoom * (event.mouseWheelScroll.delta > 0.f ? 0.8f : 1.25f), kMinZoom, kMaxZoom);
+        return;
+    }
+    if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+        const sf::Vector2i cell = cellAt(event.mouseButton.x, event.mouseButton.y);
+        if (!inside(cell)) return;
+        switch (m_tool) {
+            case Tool::Brush:
+                beginEdit();
+                setTile(cell, m_brush);
+                m_dragging = true;
+                m_lastCell = cell;
+                break;
+            case Tool::Rectangle:
+                m_dragging = true;
+                m_dragStart = m_lastCell = cell;
+                break;
+            case Tool::Fill: floodFill(cell, m_brush); break;
+            case Tool::Entry: setEntry(cell); break;
+            case Tool::Exit: setExit(cell); break;
+        }
+        return;
+    }
+    if (event.type == sf::Event::MouseMoved && m_dragging) {
+        sf::Vector2i cell = cellAt(event.mouseMove.x, event.mouseMove.y);
+        cell.x = std::clamp(cell.x, 0, m_width - 1);
+        cell.y = std::clamp(cell.y, 0, m_height - 1);
+        if (cell == m_lastCell) return;
+        if (m_tool == Tool::Brush) paintLine(m_lastCell, cell);
+        m_lastCell = cell;
+        return;
     }
-    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::E) {
-        exportJson("editor_export.json");
+    if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left && m_dragging) {
+        m_dragging = false;
+        if (m_tool == Tool::Brush) {
+            endEdit();
+        } else if (m_tool == Tool::Rectangle) {
+            fillRect(m_dragStart, m_lastCell, m_brush);
+        }
     }
 }
 
-void LevelEditor::draw(sf::RenderWindow& window) const {
+void LevelEditor::draw(sf::RenderWindow& window) {
+    TD_PROFILE_SCOPE("LevelEditor::draw");
+    m_viewport = sf::Vector2f(window.getSize());
+    const sf::View screen = window.getView();
+    window.setView(sf::View(m_center, m_viewport * m_zoom));
+    m_tilemap.draw(window);
+    if (m_routeVertices.getVertexCount() > 0) window.draw(m_routeVertices);
+
+    const float tileSize = static_cast<float>(m_tileSize);
+    if (m_dragging && m_tool == Tool::Rectangle) {
+        const sf::Vector2i min{std::min(m_dragStart.x, m_lastCell.x), std::min(m_dragStart.y, m_lastCell.y)};
+        const sf::Vector2i max{std::max(m_dragStart.x, m_lastCell.x), std::max(m_dragStart.y, m_lastCell.y)};
+        sf::RectangleShape preview({(max.x - min.x + 1) * tileSize, (max.y - min.y + 1) * tileSize});
+        preview.setPosition(min.x * tileSize, min.y * tileSize);
+        preview.setFillColor(sf::Color(255, 255, 255, 40));
+        preview.setOutlineColor(sf::Color::White);
+        preview.setOutlineThickness(m_zoom);
+        window.draw(preview);
+    }
+    for (const auto& [cell, color] : {std::pair{m_entry, sf::Color(60, 200, 255)}, std::pair{m_exit, sf::Color(255, 80, 80)}}) {
+        if (!inside(cell)) continue;
+        sf::RectangleShape marker({tileSize, tileSize});
+        marker.setPosition(cell.x * tileSize, cell.y * tileSize);
+        marker.setFillColor(sf::Color::Transparent);
+        marker.setOutlineColor(color);
+        marker.setOutlineThickness(-std::max(2.f, tileSize * 0.15f));
+        window.draw(marker);
+    }
+    window.setView(screen);
+
+    m_hint.setPosition(10.f, m_viewport.y - 50.f);
+    m_status.setPosition(10.f, m_viewport.y - 28.f);
     window.draw(m_hint);
-    sf::RectangleShape tile({static_cast<float>(m_tileSize - 2), static_cast<float>(m_tileSize - 2)});
-    for (int y = 0; y < m_height; ++y) {
-        for (int x = 0; x < m_width; ++x) {
-            int value = m_data[x + y * m_width];
-            tile.setPosition(static_cast<float>(x * m_tileSize + 1), static_cast<float>(y * m_tileSize + 1));
-            if (value == 0) tile.setFillColor(sf::Color(40, 40, 40));
-            if (value == 1) tile.setFillColor(sf::Color(100, 80, 20));
-            if (value == 2) tile.setFillColor(sf::Color(50, 120, 50));
-            window.draw(tile);
+    window.draw(m_status);
+}
+
+void LevelEditor::fillRect(const sf::Vector2i& from, const sf::Vector2i& to, TileKind kind) {
+    const int left = std::max(0, std::min(from.x, to.x));
+    const int top = std::max(0, std::min(from.y, to.y));
+    const int right = std::min(m_width - 1, std::max(from.x, to.x));
+    const int bottom = std::min(m_height - 1, std::max(from.y, to.y));
+    beginEdit();
+    for (int y = top; y <= bottom; ++y) {
+        for (int x = left; x <= right; ++x) setTile({x, y}, kind);
+    }
+    endEdit();
+}
+
+void LevelEditor::floodFill(const sf::Vector2i& start, TileKind kind) {
+    if (!inside(start)) return;
+    const TileKind target = tile(start.x, start.y);
+    if (target == kind) return;
+    beginEdit();
+    // Cells are recoloured when pushed, so nothing is queued twice.
+    std::vector<sf::Vector2i> stack{start};
+    setTile(start, kind);
+    while (!stack.empty()) {
+        const sf::Vector2i cell = stack.back();
+        stack.pop_back();
+        for (const sf::Vector2i& step : {sf::Vector2i(1, 0), sf::Vector2i(-1, 0), sf::Vector2i(0, 1), sf::Vector2i(0, -1)}) {
+            const sf::Vector2i next = cell + step;
+            if (!inside(next) || tile(next.x, next.y) != target) continue;
+            setTile(next, kind);
+            stack.push_back(next);
         }
     }
+    endEdit();
+}
+
+bool LevelEditor::undo() {
+    if (m_editing || m_applied == 0) return false;
+    const Edit& edit = m_edits[--m_applied];
+    for (std::size_t i = edit.end; i-- > edit.begin;) {
+        const TileChange& change = m_changes[i];
+        m_tiles[change.index] = change.before;
+        m_tilemap.setTile(static_cast<int>(change.index % m_width), static_cast<int>(change.index / m_width), change.before);
+    }
+    validate();
+    return true;
+}
+
+bool LevelEditor::redo() {
+    if (m_editing || m_applied == m_edits.size()) return false;
+    const Edit& edit = m_edits[m_applied++];
+    for (std::size_t i = edit.begin; i < edit.end; ++i) {
+        const TileChange& change = m_changes[i];
+        m_tiles[change.index] = change.after;
+        m_tilemap.setTile(static_cast<int>(change.index % m_width), static_cast<int>(change.index / m_width), change.after);
+    }
+    validate();
+    return true;
+}
+
+void LevelEditor::setEntry(const sf::Vector2i& cell) {
+    if (!inside(cell)) return;
+    m_entry = cell;
+    validate();
+}
+
+void LevelEditor::setExit(const sf::Vector2i& cell) {
+    if (!inside(cell)) return;
+    m_exit = cell;
+    validate();
+}
+
+std::vector<sf::Vector2i> LevelEditor::findPath() const {
+    TD_PROFILE_SCOPE("LevelEditor::findPath");
+    std::vector<sf::Vector2i> route;
+    if (!inside(m_entry) || !inside(m_exit)) return route;
+    if (tile(m_entry.x, m_entry.y) != TileKind::Path || tile(m_exit.x, m_exit.y) != TileKind::Path) return route;
+
+    // Breadth-first search; `from` holds each reached cell's predecessor index.
+    constexpr std::int32_t kUnvisited = -1;
+    std::vector<std::int32_t> from(m_tiles.size(), kUnvisited);
+    std::vector<std::int32_t> queue;
+    queue.reserve(m_tiles.size());
+    const auto startIndex = static_cast<std::int32_t>(index(m_entry.x, m_entry.y));
+    const auto goalIndex = static_cast<std::int32_t>(index(m_exit.x, m_exit.y));
+    from[static_cast<std::size_t>(startIndex)] = startIndex;
+    queue.push_back(startIndex);
+    for (std::size_t head = 0; head < queue.size() && from[static_cast<std::size_t>(goalIndex)] == kUnvisited; ++head) {
+        const std::int32_t current = queue[head];
+        const int x = current % m_width;
+        const int y = current / m_width;
+        for (const sf::Vector2i& step : {sf::Vector2i(1, 0), sf::Vector2i(-1, 0), sf::Vector2i(0, 1), sf::Vector2i(0, -1)}) {
+            const sf::Vector2i next{x + step.x, y + step.y};
+            if (!inside(next)) continue;
+            const std::size_t nextIndex = index(next.x, next.y);
+            if (from[nextIndex] != kUnvisited || m_tiles[nextIndex] != TileKind::Path) continue;
+            from[nextIndex] = current;
+            queue.push_back(static_cast<std::int32_t>(nextIndex));
+        }
+    }
+    if (from[static_cast<std::size_t>(goalIndex)] == kUnvisited) return route;
+    for (std::int32_t at = goalIndex;; at = from[static_cast<std::size_t>(at)]) {
+        route.push_back({at % m_width, at / m_width});
+        if (at == startIndex) break;
+    }
+    std::reverse(route.begin(), route.end());
+    return route;
+}
+
+void LevelEditor::beginEdit() {
+    // A new action discards everything that was undone.
+    const std::size_t keep = m_applied > 0 ? m_edits[m_applied - 1].end : 0;
+    m_edits.resize(m_applied);
+    m_changes.resize(keep);
+    m_openEdit = m_changes.size();
+    m_editing = true;
+}
+
+void LevelEditor::setTile(const sf::Vector2i& cell, TileKind kind) {
+    const std::size_t at = index(cell.x, cell.y);
+    if (m_tiles[at] == kind) return;
+    m_changes.push_back({static_cast<std::uint32_t>(at), m_tiles[at], kind});
+    m_tiles[at] = kind;
+    m_tilemap.setTile(cell.x, cell.y, kind);
+}
+
+void LevelEditor::endEdit() {
+    if (!m_editing) return;
+    m_editing = false;
+    if (m_changes.size() == m_openEdit) return;
+    m_edits.push_back({m_openEdit, m_changes.size()});
+    m_applied = m_edits.size();
+    trimHistory();
+    validate();
+}
+
+void LevelEditor::trimHistory() {
+    if (m_changes.size() <= kMaxHistoryChanges) return;
+    // Always keep the latest edit, even if it alone is over the limit.
+    std::size_t drop = 0;
+    std::size_t removed = 0;
+    while (drop + 1 < m_edits.size() && m_changes.size() - removed > kMaxHistoryChanges) {
+        removed = m_edits[drop++].end;
+    }
+    if (drop == 0) return;
+    m_changes.erase(m_changes.begin(), m_changes.begin() + static_cast<std::ptrdiff_t>(removed));
+    m_edits.erase(m_edits.begin(), m_edits.begin() + static_cast<std::ptrdiff_t>(drop));
+    for (auto& edit : m_edits) {
+        edit.begin -= removed;
+        edit.end -= removed;
+    }
+    m_applied = m_edits.size();
+}
+
+void LevelEditor::paintLine(const sf::Vector2i& from, const sf::Vector2i& to) {
+    // Fast drags skip cells between mouse events; fill them in.
+    const int steps = std::max(std::abs(to.x - from.x), std::abs(to.y - from.y));
+    for (int step = 1; step <= steps; ++step) {
+        const float t = static_cast<float>(step) / static_cast<float>(steps);
+        setTile({from.x + static_cast<int>(std::lround((to.x - from.x) * t)), from.y + static_cast<int>(std::lround((to.y - from.y) * t))},
+                m_brush);
+    }
+}
+
+void LevelEditor::validate() {
+    m_route = findPath();
+    m_routeVertices.clear();
+    const float tileSize = static_cast<float>(m_tileSize);
+    const float inset = tileSize * 0.35f;
+    for (const auto& cell : m_route) {
+        appendQuad(m_routeVertices, cell.x * tileSize + inset, cell.y * tileSize + inset, tileSize - 2.f * inset,
+                   sf::Color(255, 230, 120, 180));
+    }
+    refreshStatus();
+}
+
+void LevelEditor::refreshStatus() {
+    std::string status = std::to_string(m_width) + "x" + std::to_string(m_height) + "  tool: " + toolName(m_tool) +
+                         "  tile: " + kindName(m_brush) + "  undo: " + std::to_string(m_applied) + "/" +
+                         std::to_string(m_edits.size()) + "  path: ";
+    if (!inside(m_entry) || !inside(m_exit)) {
+        status += "set entry (S) and exit (X)";
+    } else if (m_route.empty()) {
+        status += "blocked";
+    } else {
+        status += "ok, " + std::to_string(m_route.size()) + " tiles";
+    }
+    // Only re-layout the text when it actually changed.
+    if (status != m_statusString) {
+        m_statusString = std::move(status);
+        m_status.setString(m_statusString);
+    }
+}
+
+sf::Vector2i LevelEditor::cellAt(int pixelX, int pixelY) const {
+    const sf::Vector2f world = m_center + (sf::Vector2f(static_cast<float>(pixelX), static_cast<float>(pixelY)) - m_viewport * 0.5f) * m_zoom;
+    return {static_cast<int>(std::floor(world.x / m_tileSize)), static_cast<int>(std::floor(world.y / m_tileSize))};
 }
 
 void LevelEditor::exportJson(const std::string& path) const {
-    const nlohmann::json level{{"width", m_width},
-                               {"height", m_height},
-                               {"tileSize", m_tileSize},
-                               {"data", m_data}};
+    using nlohmann::json;
+    auto cells = [this](TileKind kind) {
+        json::array_t out;
+        for (int y = 0; y < m_height; ++y) {
+            for (int x = 0; x < m_width; ++x) {
+                if (tile(x, y) == kind) out.push_back(json(json::array_t{x, y}));
+            }
+        }
+        return out;
+    };
+    // The route is stored as its corners, which is how level files describe paths.
+    json::array_t points;
+    for (std::size_t i = 0; i < m_route.size(); ++i) {
+        const bool corner = i == 0 || i + 1 == m_route.size() ||
+                            (m_route[i - 1].x != m_route[i + 1].x && m_route[i - 1].y != m_route[i + 1].y);
+        if (corner) points.push_back(json(json::array_t{m_route[i].x, m_route[i].y}));
+    }
+    json::array_t paths;
+    if (!points.empty()) {
+        paths.push_back(json{{"id", "main"}, {"points", json(points)}});
+    } else {
+        std::cerr << "[Editor] No valid path from entry to exit; exporting without paths" << std::endl;
+    }
+
+    const json level{{"id", "editor_export"},
+                     {"name", "Editor Export"},
+                     {"biome", "meadow"},
+                     {"grid", json{{"width", m_width}, {"height", m_height}, {"tileSize", m_tileSize}}},
+                     {"paths", json(paths)},
+                     {"buildable", json(cells(TileKind::Buildable))},
+                     {"obstacles", json(cells(TileKind::Obstacle))},
+                     {"rules", json(json::array_t{"standard"})},
+                     {"waves", "level_01"},
+                     {"startCoins", 300},
+                     {"startLives", 20}};
     std::ofstream file(path);
     file << level.dump(2);
 }
 
 } // namespace levels
-
@@ -1,24 +1,97 @@
 #pragma once
 
+#include "Tilemap.hpp"
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace levels {
 
+// Grid editor for level layouts. Tiles are drawn through a chunked
+// TilemapRenderer that is patched per edited tile, every edit is recorded as
+// per-tile deltas for undo/redo, and the route from entry to exit is checked
+// with a BFS over path tiles after each edit.
 class LevelEditor {
 public:
+    enum class Tool { Brush, Rectangle, Fill, Entry, Exit };
+
     void init(int width, int height, int tileSize, const sf::Font& font);
     void handleEvent(const sf::Event& event);
-    void draw(sf::RenderWindow& window) const;
+    void draw(sf::RenderWindow& window);
     void exportJson(const std::string& path) const;
 
+    // Each call is one undo step.
+    void fillRect(const sf::Vector2i& from, const sf::Vector2i& to, TileKind kind);
+    void floodFill(const sf::Vector2i& start, TileKind kind);
+    bool undo();
+    bool redo();
+
+    void setEntry(const sf::Vector2i& cell);
+    void setExit(const sf::Vector2i& cell);
+    // Shortest 4-connected route over path tiles from entry to exit, both
+    // included; empty when either is unset or they are not connected.
+    std::vector<sf::Vector2i> findPath() const;
+
+    TileKind tile(int x, int y) const { return m_tiles[index(x, y)]; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
 private:
+    struct TileChange {
+        std::uint32_t index;
+        TileKind before;
+        TileKind after;
+    };
+    // Range of m_changes written by one user action.
+    struct Edit {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    std::size_t index(int x, int y) const { return static_cast<std::size_t>(x + y * m_width); }
+    bool inside(const sf::Vector2i& cell) const { return cell.x >= 0 && cell.y >= 0 && cell.x < m_width && cell.y < m_height; }
+    void resize(int width, int height);
+    void beginEdit();
+    void setTile(const sf::Vector2i& cell, TileKind kind);
+    void endEdit();
+    void trimHistory();
+    void paintLine(const sf::Vector2i& from, const sf::Vector2i& to);
+    void validate();
+    void refreshStatus();
+    sf::Vector2i cellAt(int pixelX, int pixelY) const;
+
     int m_width = 0;
     int m_height = 0;
     int m_tileSize = 40;
-    std::vector<int> m_data;
+    std::vector<TileKind> m_tiles;
+    TilemapRenderer m_tilemap;
+
+    std::vector<TileChange> m_changes;
+    std::vector<Edit> m_edits;
+    std::size_t m_applied = 0; // edits in m_edits that are currently applied
+    std::size_t m_openEdit = 0;
+    bool m_editing = false;
+
+    Tool m_tool = Tool::Brush;
+    TileKind m_brush = TileKind::Path;
+    bool m_dragging = false;
+    sf::Vector2i m_dragStart;
+    sf::Vector2i m_lastCell;
+
+    sf::Vector2i m_entry{-1, -1};
+    sf::Vector2i m_exit{-1, -1};
+    std::vector<sf::Vector2i> m_route;
+    sf::VertexArray m_routeVertices{sf::Quads};
+
+    sf::Vector2f m_center;
+    sf::Vector2f m_viewport{1280.f, 720.f};
+    float m_zoom = 1.f;
+    std::size_t m_sizePreset = 0;
+
     sf::Text m_hint;
+    sf::Text m_status;
+    std::string m_statusString;
 };
 
 } // namespace levels
-
@@ -1,38 +1,183 @@
 #include "Tilemap.hpp"
 
+#include "../core/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
 namespace levels {
 
-void TilemapRenderer::build(const LevelRuntime& level, const sf::Texture& texture) {
+sf::Color tileColor(TileKind kind) {
+    switch (kind) {
+        case TileKind::Path: return sf::Color(90, 75, 50);
+        case TileKind::Buildable: return sf::Color(40, 85, 40);
+        case TileKind::Obstacle: return sf::Color(55, 55, 60);
+        case TileKind::Ground:
+        default: return sf::Color(30, 60, 30);
+    }
+}
+
+std::vector<TileKind> rasterizeTiles(const data::LevelDefinition& def) {
+    const int width = std::max(0, def.width);
+    const int height = std::max(0, def.height);
+    std::vector<TileKind> tiles(static_cast<std::size_t>(width * height), TileKind::Ground);
+    auto mark = [&](int x, int y, TileKind kind) {
+        if (x >= 0 && y >= 0 && x < width && y < height) tiles[static_cast<std::size_t>(x + y * width)] = kind;
+    };
+    for (const auto& flat : def.paths) {
+        for (std::size_t i = 0; i + 3 < flat.size(); i += 2) {
+            const int dx = flat[i + 2] - flat[i];
+            const int dy = flat[i + 3] - flat[i + 1];
+            const int steps = std::max(std::abs(dx), std::abs(dy));
+            for (int step = 0; step <= steps; ++step) {
+                const float t = steps > 0 ? static_cast<float>(step) / static_cast<float>(steps) : 0.f;
+                mark(flat[i] + static_cast<int>(std::lround(dx * t)), flat[i + 1] + static_cast<int>(std::lround(dy * t)),
+                     TileKind::Path);
+            }
+        }
+    }
+    for (const auto& cell : def.buildable) mark(cell.x, cell.y, TileKind::Buildable);
+    for (const auto& cell : def.obstacles) mark(cell.x, cell.y, TileKind::Obstacle);
+    return tiles;
+}
+
+void TilemapRenderer::build(const LevelRuntime& level, const sf::Texture& texture, const sf::IntRect& region) {
+    const auto& def = level.definition;
     m_texture = &texture;
-    m_vertices.setPrimitiveType(sf::Quads);
-    m_vertices.resize(level.definition.width * level.definition.height * 4);
-    auto tileSize = static_cast<float>(level.definition.tileSize);
-    for (int y = 0; y < level.definition.height; ++y) {
-        for (int x = 0; x < level.definition.width; ++x) {
-            sf::Vertex* quad = &m_vertices[(x + y * level.definition.width) * 4];
-            float px = x * tileSize;
-            float py = y * tileSize;
+    m_width = std::max(0, def.width);
+    m_height = std::max(0, def.height);
+    m_tileSize = static_cast<float>(def.tileSize);
+    m_texCoords = sf::FloatRect(static_cast<float>(region.left), static_cast<float>(region.top),
+                                static_cast<float>(region.width), static_cast<float>(region.height));
+    m_useBuffers = sf::VertexBuffer::isAvailable();
+    m_tiles = rasterizeTiles(def);
+    allocateChunks();
+}
+
+void TilemapRenderer::build(int width, int height, float tileSize, TileKind fill) {
+    m_texture = nullptr;
+    m_width = std::max(0, width);
+    m_height = std::max(0, height);
+    m_tileSize = tileSize;
+    m_texCoords = sf::FloatRect();
+    m_useBuffers = sf::VertexBuffer::isAvailable();
+    m_tiles.assign(static_cast<std::size_t>(m_width * m_height), fill);
+    allocateChunks();
+}
+
+void TilemapRenderer::allocateChunks() {
+    m_chunksX = (m_width + kChunkTiles - 1) / kChunkTiles;
+    m_chunksY = (m_height + kChunkTiles - 1) / kChunkTiles;
+    m_chunks.clear();
+    m_chunks.resize(static_cast<std::size_t>(m_chunksX * m_chunksY));
+    for (int cy = 0; cy < m_chunksY; ++cy) {
+        for (int cx = 0; cx < m_chunksX; ++cx) {
+            Chunk& chunk = m_chunks[static_cast<std::size_t>(cx + cy * m_chunksX)];
+            chunk.tileX = cx * kChunkTiles;
+            chunk.tileY = cy * kChunkTiles;
+            chunk.width = std::min(kChunkTiles, m_width - chunk.tileX);
+            chunk.height = std::min(kChunkTiles, m_height - chunk.tileY);
+            chunk.dirty = true;
+        }
+    }
+}
+
+void TilemapRenderer::setTile(int x, int y, TileKind kind) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return;
+    TileKind& current = m_tiles[static_cast<std::size_t>(x + y * m_width)];
+    if (current == kind) return;
+    current = kind;
+    Chunk& chunk = m_chunks[static_cast<std::size_t>(x / kChunkTiles + (y / kChunkTiles) * m_chunksX)];
+    if (chunk.dirty) return;
+    const std::size_t first = static_cast<std::size_t>(((x - chunk.tileX) + (y - chunk.tileY) * chunk.width) * 4);
+    const sf::Color color = tileColor(kind);
+    for (std::size_t i = first; i < first + 4; ++i) {
+        chunk.vertices[i].color = color;
+    }
+    if (chunk.uploadBegin >= chunk.uploadEnd) {
+        chunk.uploadBegin = first;
+        chunk.uploadEnd = first + 4;
+    } else {
+        chunk.uploadBegin = std::min(chunk.uploadBegin, first);
+        chunk.uploadEnd = std::max(chunk.uploadEnd, first + 4);
+    }
+}
+
+void TilemapRenderer::rebuild(Chunk& chunk) {
+    chunk.vertices.resize(static_cast<std::size_t>(chunk.width * chunk.height * 4));
+    const float left = m_texCoords.left;
+    const float top = m_texCoords.top;
+    const float right = left + m_texCoords.width;
+    const float bottom = top + m_texCoords.height;
+    for (int y = 0; y < chunk.height; ++y) {
+        for (int x = 0; x < chunk.width; ++x) {
+            sf::Vertex* quad = &chunk.vertices[static_cast<std::size_t>((x + y * chunk.width) * 4)];
+            const float px = static_cast<float>(chunk.tileX + x) * m_tileSize;
+            const float py = static_cast<float>(chunk.tileY + y) * m_tileSize;
             quad[0].position = {px, py};
-            quad[1].position = {px + tileSize, py};
-            quad[2].position = {px + tileSize, py + tileSize};
-            quad[3].position = {px, py + tileSize};
-            quad[0].texCoords = {0.f, 0.f};
-            quad[1].texCoords = {texture.getSize().x * 1.f, 0.f};
-            quad[2].texCoords = {texture.getSize().x * 1.f, texture.getSize().y * 1.f};
-            quad[3].texCoords = {0.f, texture.getSize().y * 1.f};
+            quad[1].position = {px + m_tileSize, py};
+            quad[2].position = {px + m_tileSize, py + m_tileSize};
+            quad[3].position = {px, py + m_tileSize};
+            quad[0].texCoords = {left, top};
+            quad[1].texCoords = {right, top};
+            quad[2].texCoords = {right, bottom};
+            quad[3].texCoords = {left, bottom};
+            const sf::Color color = tileColor(tile(chunk.tileX + x, chunk.tileY + y));
             for (int i = 0; i < 4; ++i) {
-                quad[i].color = sf::Color(30, 60, 30);
+                quad[i].color = color;
             }
         }
     }
+    if (m_useBuffers) {
+        if (chunk.buffer.getVertexCount() != chunk.vertices.size()) chunk.buffer.create(chunk.vertices.size());
+        chunk.buffer.update(chunk.vertices.data());
+    }
+    chunk.dirty = false;
+    chunk.uploadBegin = chunk.uploadEnd = 0;
+}
+
+void TilemapRenderer::upload(Chunk& chunk) {
+    if (m_useBuffers) {
+        chunk.buffer.update(chunk.vertices.data() + chunk.uploadBegin, chunk.uploadEnd - chunk.uploadBegin,
+                            static_cast<unsigned>(chunk.uploadBegin));
+    }
+    chunk.uploadBegin = chunk.uploadEnd = 0;
 }
 
-void TilemapRenderer::draw(sf::RenderWindow& window) const {
-    if (!m_texture) return;
+void TilemapRenderer::draw(sf::RenderTarget& target) {
+    TD_PROFILE_SCOPE("TilemapRenderer::draw");
+    m_lastDrawn = 0;
+    if (m_chunks.empty() || m_tileSize <= 0.f) return;
+
+    // Axis-aligned bounds of the view; the game never rotates it.
+    const sf::View& view = target.getView();
+    const sf::Vector2f half = view.getSize() * 0.5f;
+    const sf::Vector2f min = view.getCenter() - half;
+    const sf::Vector2f max = view.getCenter() + half;
+    const float chunkSize = m_tileSize * kChunkTiles;
+    const int firstX = std::max(0, static_cast<int>(std::floor(min.x / chunkSize)));
+    const int firstY = std::max(0, static_cast<int>(std::floor(min.y / chunkSize)));
+    const int lastX = std::min(m_chunksX - 1, static_cast<int>(std::floor(max.x / chunkSize)));
+    const int lastY = std::min(m_chunksY - 1, static_cast<int>(std::floor(max.y / chunkSize)));
+
     sf::RenderStates states;
     states.texture = m_texture;
-    window.draw(m_vertices, states);
+    for (int cy = firstY; cy <= lastY; ++cy) {
+        for (int cx = firstX; cx <= lastX; ++cx) {
+            Chunk& chunk = m_chunks[static_cast<std::size_t>(cx + cy * m_chunksX)];
+            if (chunk.dirty) {
+                rebuild(chunk);
+            } else if (chunk.uploadBegin < chunk.uploadEnd) {
+                upload(chunk);
+            }
+            if (m_useBuffers) {
+                target.draw(chunk.buffer, states);
+            } else {
+                target.draw(chunk.vertices.data(), chunk.vertices.size(), sf::Quads, states);
+            }
+            ++m_lastDrawn;
+        }
+    }
 }
 
 } // namespace levels
-
@@ -2,18 +2,68 @@
 
 #include "LevelLoader.hpp"
 #include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
 
 namespace levels {
 
+enum class TileKind : std::uint8_t { Ground, Path, Buildable, Obstacle };
+
+// Row-major width x height grid: path segments, then buildable cells, then obstacles.
+std::vector<TileKind> rasterizeTiles(const data::LevelDefinition& def);
+sf::Color tileColor(TileKind kind);
+
+// Draws the level grid in square chunks of kChunkTiles tiles. Only chunks that
+// intersect the target's current view are submitted, and a changed tile only
+// patches its own four vertices, so cost follows the visible area and the
+// number of edits, not the map size.
 class TilemapRenderer {
 public:
-    void build(const LevelRuntime& level, const sf::Texture& texture);
-    void draw(sf::RenderWindow& window) const;
+    static constexpr int kChunkTiles = 16;
+
+    // Every tile samples `region` of `texture`, typically an atlas page.
+    void build(const LevelRuntime& level, const sf::Texture& texture, const sf::IntRect& region);
+    // Untextured grid filled with `fill`; tiles are drawn in their flat colours.
+    void build(int width, int height, float tileSize, TileKind fill = TileKind::Ground);
+    // The tile's vertices are patched now and uploaded on the next draw.
+    void setTile(int x, int y, TileKind kind);
+    TileKind tile(int x, int y) const { return m_tiles[static_cast<std::size_t>(x + y * m_width)]; }
+
+    void draw(sf::RenderTarget& target);
+
+    sf::Vector2f worldSize() const { return {m_width * m_tileSize, m_height * m_tileSize}; }
+    std::size_t chunkCount() const { return m_chunks.size(); }
+    std::size_t lastDrawnChunks() const { return m_lastDrawn; }
 
 private:
-    sf::VertexArray m_vertices;
+    struct Chunk {
+        int tileX = 0;
+        int tileY = 0;
+        int width = 0;
+        int height = 0;
+        std::vector<sf::Vertex> vertices;
+        sf::VertexBuffer buffer{sf::Quads, sf::VertexBuffer::Static};
+        bool dirty = true;
+        // Vertex range patched since the last upload; empty when begin >= end.
+        std::size_t uploadBegin = 0;
+        std::size_t uploadEnd = 0;
+    };
+
+    void allocateChunks();
+    void rebuild(Chunk& chunk);
+    void upload(Chunk& chunk);
+
+    std::vector<TileKind> m_tiles;
+    std::vector<Chunk> m_chunks;
+    int m_width = 0;
+    int m_height = 0;
+    int m_chunksX = 0;
+    int m_chunksY = 0;
+    float m_tileSize = 0.f;
+    sf::FloatRect m_texCoords;
     sf::Texture const* m_texture = nullptr;
+    bool m_useBuffers = false;
+    std::size_t m_lastDrawn = 0;
 };
 
 } // namespace levels
-
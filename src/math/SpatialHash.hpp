@@ -1,6 +1,8 @@
 #pragma once
 
 #include <SFML/System/Vector2.hpp>
+#include <cmath>
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 
@@ -32,11 +34,43 @@ public:
         }
     }
 
+    // Every index in a cell overlapping [min, max]. Indices near the edges may
+    // lie slightly outside the rectangle; callers test exact bounds themselves.
+    template <typename Fn>
+    void queryRect(const sf::Vector2f& min, const sf::Vector2f& max, Fn&& fn) const {
+        const int x0 = cellCoord(min.x);
+        const int y0 = cellCoord(min.y);
+        const int x1 = cellCoord(max.x);
+        const int y1 = cellCoord(max.y);
+        const auto span = static_cast<std::size_t>(x1 - x0 + 1) * static_cast<std::size_t>(y1 - y0 + 1);
+        if (span > m_cells.size()) {
+            // Fewer occupied cells than cells in the rectangle: walk the occupied ones.
+            for (const auto& [key, cell] : m_cells) {
+                const int y = static_cast<std::int32_t>(key & 0xffffffff);
+                const int x = static_cast<int>((key ^ static_cast<std::int64_t>(y)) >> 32);
+                if (x < x0 || x > x1 || y < y0 || y > y1) continue;
+                for (auto index : cell.indices) fn(index);
+            }
+            return;
+        }
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                auto it = m_cells.find(cellKey(x, y));
+                if (it == m_cells.end()) continue;
+                for (auto index : it->second.indices) fn(index);
+            }
+        }
+    }
+
+    float cellSize() const { return m_cellSize; }
+
 private:
+    int cellCoord(float value) const { return static_cast<int>(std::floor(value / m_cellSize)); }
+
+    static std::int64_t cellKey(int x, int y) { return (static_cast<std::int64_t>(x) << 32) ^ y; }
+
     std::int64_t cellKey(const sf::Vector2f& position) const {
-        int x = static_cast<int>(std::floor(position.x / m_cellSize));
-        int y = static_cast<int>(std::floor(position.y / m_cellSize));
-        return (static_cast<std::int64_t>(x) << 32) ^ y;
+        return cellKey(cellCoord(position.x), cellCoord(position.y));
     }
 
     float m_cellSize;
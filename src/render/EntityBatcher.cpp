@@ -0,0 +1,156 @@
+#include "EntityBatcher.hpp"
+
+#include "../core/Profiler.hpp"
+#include <array>
+#include <cmath>
+
+namespace render {
+
+namespace {
+
+constexpr std::size_t kCircleSegments = 12;
+constexpr std::size_t kCircleVertices = kCircleSegments * 3;
+constexpr std::size_t kQuadVertices = 6;
+
+// Overlay geometry, relative to the enemy centre.
+constexpr float kBarWidth = 22.f;
+constexpr float kBarHeight = 3.f;
+constexpr float kBarOffsetY = -19.f;
+constexpr float kPipSize = 4.f;
+constexpr float kPipSpacing = 5.f;
+constexpr float kPipOffsetY = 14.f;
+
+struct LayerStyle {
+    float radius;
+    sf::Color color;
+};
+
+// Indexed by RenderLayer.
+const std::array<LayerStyle, kRenderLayerCount> kLayerStyles{{
+    {12.f, sf::Color(255, 0, 0)},     // Ground
+    {12.f, sf::Color(0, 0, 255)},     // Towers
+    {10.f, sf::Color(255, 120, 160)}, // Flyers
+    {6.f, sf::Color(255, 255, 0)},    // Projectiles
+    {4.f, sf::Color(255, 200, 120)},  // Effects
+}};
+
+const sf::Color kBarBackground(30, 30, 30, 200);
+const sf::Color kBarFill(90, 220, 90);
+
+// Indexed by StatusPip.
+const std::array<sf::Color, kStatusPipCount> kPipColors{{
+    sf::Color(120, 200, 255), // Slow
+    sf::Color(255, 130, 40),  // Burn
+    sf::Color(140, 220, 60),  // Poison
+    sf::Color(250, 250, 120), // Shock
+    sf::Color(190, 120, 230), // Weaken
+    sf::Color(220, 220, 220), // Other
+}};
+
+// Unit circle rim, shared by every fan.
+const std::array<sf::Vector2f, kCircleSegments + 1>& unitCircle() {
+    static const auto points = [] {
+        std::array<sf::Vector2f, kCircleSegments + 1> rim{};
+        for (std::size_t i = 0; i <= kCircleSegments; ++i) {
+            const float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(kCircleSegments);
+            rim[i] = {std::cos(angle), std::sin(angle)};
+        }
+        return rim;
+    }();
+    return points;
+}
+
+void writeCircle(sf::Vertex* out, const sf::Vector2f& center, float radius, const sf::Color& color) {
+    const auto& rim = unitCircle();
+    for (std::size_t i = 0; i < kCircleSegments; ++i) {
+        out[0] = sf::Vertex(center, color);
+        out[1] = sf::Vertex(center + rim[i] * radius, color);
+        out[2] = sf::Vertex(center + rim[i + 1] * radius, color);
+        out += 3;
+    }
+}
+
+void writeQuad(sf::Vertex* out, float left, float top, float width, float height, const sf::Color& color) {
+    const sf::Vector2f a{left, top};
+    const sf::Vector2f b{left + width, top};
+    const sf::Vector2f c{left + width, top + height};
+    const sf::Vector2f d{left, top + height};
+    out[0] = sf::Vertex(a, color);
+    out[1] = sf::Vertex(b, color);
+    out[2] = sf::Vertex(c, color);
+    out[3] = sf::Vertex(a, color);
+    out[4] = sf::Vertex(c, color);
+    out[5] = sf::Vertex(d, color);
+}
+
+int pipCount(std::uint8_t statuses) {
+    int count = 0;
+    for (; statuses != 0; statuses &= static_cast<std::uint8_t>(statuses - 1)) ++count;
+    return count;
+}
+
+} // namespace
+
+void EntityBatcher::build(const RenderList& list) {
+    TD_PROFILE_SCOPE("EntityBatcher::build");
+    for (std::size_t layer = 0; layer < kRenderLayerCount; ++layer) {
+        sf::VertexArray& vertices = m_layers[layer];
+        const auto& items = list.layers[layer];
+        const LayerStyle& style = kLayerStyles[layer];
+        vertices.setPrimitiveType(sf::Triangles);
+        vertices.resize(items.size() * kCircleVertices);
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            writeCircle(&vertices[i * kCircleVertices], items[i].position, style.radius, style.color);
+        }
+    }
+    buildOverlay(list);
+}
+
+void EntityBatcher::buildOverlay(const RenderList& list) {
+    const auto& ground = list.layer(RenderLayer::Ground);
+    const auto& flyers = list.layer(RenderLayer::Flyers);
+
+    // Size the array first so it is written in place without growing.
+    std::size_t quads = 0;
+    for (const auto* items : {&ground, &flyers}) {
+        for (const RenderItem& item : *items) {
+            if (item.health < 1.f) quads += 2;
+            quads += static_cast<std::size_t>(pipCount(item.statuses));
+        }
+    }
+    m_overlay.setPrimitiveType(sf::Triangles);
+    m_overlay.resize(quads * kQuadVertices);
+
+    std::size_t cursor = 0;
+    auto quad = [&](float left, float top, float width, float height, const sf::Color& color) {
+        writeQuad(&m_overlay[cursor], left, top, width, height, color);
+        cursor += kQuadVertices;
+    };
+    for (const auto* items : {&ground, &flyers}) {
+        for (const RenderItem& item : *items) {
+            const sf::Vector2f& p = item.position;
+            if (item.health < 1.f) {
+                const float left = p.x - kBarWidth * 0.5f;
+                quad(left, p.y + kBarOffsetY, kBarWidth, kBarHeight, kBarBackground);
+                quad(left, p.y + kBarOffsetY, kBarWidth * item.health, kBarHeight, kBarFill);
+            }
+            if (item.statuses == 0) continue;
+            float x = p.x - static_cast<float>(pipCount(item.statuses)) * kPipSpacing * 0.5f;
+            for (std::size_t pip = 0; pip < kStatusPipCount; ++pip) {
+                if (!(item.statuses & (1u << pip))) continue;
+                quad(x, p.y + kPipOffsetY, kPipSize, kPipSize, kPipColors[pip]);
+                x += kPipSpacing;
+            }
+        }
+    }
+}
+
+void EntityBatcher::draw(sf::RenderTarget& target) const {
+    TD_PROFILE_SCOPE("EntityBatcher::draw");
+    for (const auto& layer : m_layers) {
+        if (layer.getVertexCount() > 0) target.draw(layer);
+    }
+    if (m_overlay.getVertexCount() > 0) target.draw(m_overlay);
+}
+
+} // namespace render
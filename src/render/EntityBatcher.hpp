@@ -0,0 +1,28 @@
+#pragma once
+
+#include "RenderList.hpp"
+#include <SFML/Graphics.hpp>
+#include <array>
+
+namespace render {
+
+// Writes every item of a RenderList as a circle fan into one vertex array per
+// layer, so the world draws in at most kRenderLayerCount draw calls. Enemy
+// health bars and status pips go into one more array drawn on top. The arrays
+// are rebuilt each frame but keep their capacity between frames.
+class EntityBatcher {
+public:
+    void build(const RenderList& list);
+    void draw(sf::RenderTarget& target) const;
+
+    std::size_t vertexCount(RenderLayer layer) const { return m_layers[static_cast<std::size_t>(layer)].getVertexCount(); }
+    std::size_t overlayVertexCount() const { return m_overlay.getVertexCount(); }
+
+private:
+    void buildOverlay(const RenderList& list);
+
+    std::array<sf::VertexArray, kRenderLayerCount> m_layers;
+    sf::VertexArray m_overlay;
+};
+
+} // namespace render
@@ -0,0 +1,93 @@
+#include "RenderList.hpp"
+
+#include "../core/Profiler.hpp"
+#include <algorithm>
+
+namespace render {
+
+namespace {
+
+// Largest distance from an entity's centre that EntityBatcher draws at,
+// health bar included.
+constexpr float kMaxRadius = 20.f;
+
+bool overlaps(const sf::FloatRect& area, const sf::Vector2f& position) {
+    return position.x >= area.left - kMaxRadius && position.x <= area.left + area.width + kMaxRadius &&
+           position.y >= area.top - kMaxRadius && position.y <= area.top + area.height + kMaxRadius;
+}
+
+std::uint8_t statusBit(const std::string& id) {
+    StatusPip pip = StatusPip::Other;
+    if (id.find("slow") != std::string::npos) pip = StatusPip::Slow;
+    else if (id.find("burn") != std::string::npos) pip = StatusPip::Burn;
+    else if (id.find("poison") != std::string::npos) pip = StatusPip::Poison;
+    else if (id.find("shock") != std::string::npos) pip = StatusPip::Shock;
+    else if (id.find("weaken") != std::string::npos) pip = StatusPip::Weaken;
+    return static_cast<std::uint8_t>(1u << static_cast<unsigned>(pip));
+}
+
+void sortByEntity(std::vector<RenderItem>& items) {
+    std::sort(items.begin(), items.end(),
+              [](const RenderItem& a, const RenderItem& b) { return a.entity < b.entity; });
+}
+
+} // namespace
+
+sf::FloatRect visibleArea(const sf::View& view) {
+    const sf::Vector2f size = view.getSize();
+    return {view.getCenter().x - size.x * 0.5f, view.getCenter().y - size.y * 0.5f, size.x, size.y};
+}
+
+void extractVisible(const core::Simulation& sim, const sf::FloatRect& visible, RenderList& out) {
+    TD_PROFILE_SCOPE("extractVisible");
+    for (auto& layer : out.layers) layer.clear();
+    out.culled = 0;
+    const ecs::Registry& registry = sim.registry();
+
+    // Enemies have moved since the index was built; one cell of slack covers a tick of movement.
+    const auto& grid = sim.enemyGrid();
+    const auto& order = sim.enemyOrder();
+    const float slack = kMaxRadius + grid.cellSize();
+    grid.queryRect({visible.left - slack, visible.top - slack},
+                   {visible.left + visible.width + slack, visible.top + visible.height + slack}, [&](std::size_t index) {
+                       if (index >= order.size()) return;
+                       const ecs::Entity entity = order[index];
+                       auto statsIt = registry.m_enemyStats.find(entity);
+                       auto transformIt = registry.m_transforms.find(entity);
+                       if (statsIt == registry.m_enemyStats.end() || transformIt == registry.m_transforms.end()) return;
+                       if (!overlaps(visible, transformIt->second.position)) return;
+                       float health = 1.f;
+                       auto healthIt = registry.m_health.find(entity);
+                       if (healthIt != registry.m_health.end() && healthIt->second.maxHp > 0.f) {
+                           health = std::clamp(healthIt->second.hp / healthIt->second.maxHp, 0.f, 1.f);
+                       }
+                       std::uint8_t statuses = 0;
+                       auto statusIt = registry.m_statusContainers.find(entity);
+                       if (statusIt != registry.m_statusContainers.end()) {
+                           for (const auto& status : statusIt->second.active) statuses |= statusBit(status.id);
+                       }
+                       out.layer(statsIt->second.flying ? RenderLayer::Flyers : RenderLayer::Ground)
+                           .push_back({entity, transformIt->second.position, health, statuses});
+                   });
+    const std::size_t enemiesDrawn = out.layer(RenderLayer::Ground).size() + out.layer(RenderLayer::Flyers).size();
+    out.culled += registry.m_enemyStats.size() - std::min(registry.m_enemyStats.size(), enemiesDrawn);
+
+    auto collect = [&](const auto& components, RenderLayer layer) {
+        auto& items = out.layer(layer);
+        for (const auto& [entity, component] : components) {
+            auto transformIt = registry.m_transforms.find(entity);
+            if (transformIt == registry.m_transforms.end()) continue;
+            if (overlaps(visible, transformIt->second.position)) {
+                items.push_back({entity, transformIt->second.position, 1.f, 0});
+            } else {
+                ++out.culled;
+            }
+        }
+    };
+    collect(registry.m_towerStats, RenderLayer::Towers);
+    collect(registry.m_projectiles, RenderLayer::Projectiles);
+
+    for (auto& layer : out.layers) sortByEntity(layer);
+}
+
+} // namespace render
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../core/Simulation.hpp"
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace render {
+
+// Draw order, back to front. Flyers pass over towers.
+enum class RenderLayer { Ground, Towers, Flyers, Projectiles, Effects, Count };
+
+constexpr std::size_t kRenderLayerCount = static_cast<std::size_t>(RenderLayer::Count);
+
+// One pip per kind of active status, in this order left to right. Status ids
+// are matched by substring, like systems::updateStatus does for "slow".
+enum class StatusPip { Slow, Burn, Poison, Shock, Weaken, Other, Count };
+
+constexpr std::size_t kStatusPipCount = static_cast<std::size_t>(StatusPip::Count);
+
+struct RenderItem {
+    ecs::Entity entity = ecs::InvalidEntity;
+    sf::Vector2f position;
+    float health = 1.f; // hp / maxHp; always 1 for towers and projectiles
+    std::uint8_t statuses = 0; // bit per StatusPip
+};
+
+// Entities on screen for one frame, bucketed by layer and sorted by entity id
+// within a layer so that overlapping sprites keep a stable order.
+struct RenderList {
+    std::array<std::vector<RenderItem>, kRenderLayerCount> layers;
+    std::size_t culled = 0;
+
+    std::vector<RenderItem>& layer(RenderLayer id) { return layers[static_cast<std::size_t>(id)]; }
+    const std::vector<RenderItem>& layer(RenderLayer id) const { return layers[static_cast<std::size_t>(id)]; }
+};
+
+// Axis-aligned world rectangle covered by `view`.
+sf::FloatRect visibleArea(const sf::View& view);
+
+// Fills `out` with the entities overlapping `visible`, reusing its capacity.
+// Enemies come from the simulation's spatial index; towers and projectiles are
+// tested directly.
+void extractVisible(const core::Simulation& sim, const sf::FloatRect& visible, RenderList& out);
+
+} // namespace render
@@ -0,0 +1,111 @@
+#include "Particles.hpp"
+
+#include "../core/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace systems {
+
+namespace {
+constexpr float kDrag = 3.f; // fraction of velocity lost per second
+constexpr float kHalfSize = 1.5f;
+constexpr float kTwoPi = 6.2831853f;
+} // namespace
+
+ParticleSystem::ParticleSystem(std::size_t capacity)
+    : m_x(capacity), m_y(capacity), m_vx(capacity), m_vy(capacity), m_life(capacity), m_invMaxLife(capacity),
+      m_color(capacity) {}
+
+void ParticleSystem::clear() {
+    std::fill(m_life.begin(), m_life.end(), 0.f);
+    m_next = 0;
+    m_used = 0;
+    m_horizon = 0.f;
+}
+
+void ParticleSystem::spawn(const sf::Vector2f& position, const sf::Vector2f& velocity, float life, sf::Color color) {
+    if (m_life.empty() || life <= 0.f) return;
+    const std::size_t i = m_next;
+    m_next = m_next + 1 == m_life.size() ? 0 : m_next + 1;
+    m_used = std::max(m_used, i + 1);
+    m_horizon = std::max(m_horizon, life);
+    m_x[i] = position.x;
+    m_y[i] = position.y;
+    m_vx[i] = velocity.x;
+    m_vy[i] = velocity.y;
+    m_life[i] = life;
+    m_invMaxLife[i] = 1.f / life;
+    m_color[i] = color;
+}
+
+void ParticleSystem::burst(const sf::Vector2f& position, int count, float speed, float life, sf::Color color) {
+    for (int i = 0; i < count; ++i) {
+        const float angle = random01() * kTwoPi;
+        const float magnitude = speed * (0.3f + 0.7f * random01());
+        spawn(position, {std::cos(angle) * magnitude, std::sin(angle) * magnitude}, life * (0.6f + 0.4f * random01()), color);
+    }
+}
+
+void ParticleSystem::ring(const sf::Vector2f& position, float radius, int count, float life, sf::Color color) {
+    if (count <= 0 || life <= 0.f) return;
+    // Initial speed that drag slows down to cover exactly `radius` in `life` seconds.
+    const float speed = radius * kDrag / (1.f - std::exp(-kDrag * life));
+    for (int i = 0; i < count; ++i) {
+        const float angle = kTwoPi * static_cast<float>(i) / static_cast<float>(count);
+        spawn(position, {std::cos(angle) * speed, std::sin(angle) * speed}, life, color);
+    }
+}
+
+void ParticleSystem::update(float dt) {
+    if (m_horizon <= 0.f) return;
+    m_horizon -= dt;
+    TD_PROFILE_SCOPE("ParticleSystem::update");
+    // Dead particles are integrated too; skipping them would add a branch to
+    // the loop and stop it from vectorizing.
+    const float drag = std::exp(-kDrag * dt);
+    const std::size_t count = m_used;
+    float* x = m_x.data();
+    float* y = m_y.data();
+    float* vx = m_vx.data();
+    float* vy = m_vy.data();
+    float* life = m_life.data();
+    for (std::size_t i = 0; i < count; ++i) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        vx[i] *= drag;
+        vy[i] *= drag;
+        life[i] -= dt;
+    }
+}
+
+void ParticleSystem::appendQuads(std::vector<sf::Vertex>& out, const sf::FloatRect& area) const {
+    const float right = area.left + area.width;
+    const float bottom = area.top + area.height;
+    if (m_horizon <= 0.f) return;
+    for (std::size_t i = 0; i < m_used; ++i) {
+        if (m_life[i] <= 0.f) continue;
+        const float x = m_x[i];
+        const float y = m_y[i];
+        if (x < area.left || y < area.top || x > right || y > bottom) continue;
+        sf::Color color = m_color[i];
+        color.a = static_cast<sf::Uint8>(std::min(1.f, m_life[i] * m_invMaxLife[i]) * color.a);
+        out.emplace_back(sf::Vector2f{x - kHalfSize, y - kHalfSize}, color);
+        out.emplace_back(sf::Vector2f{x + kHalfSize, y - kHalfSize}, color);
+        out.emplace_back(sf::Vector2f{x + kHalfSize, y + kHalfSize}, color);
+        out.emplace_back(sf::Vector2f{x - kHalfSize, y + kHalfSize}, color);
+    }
+}
+
+std::size_t ParticleSystem::alive() const {
+    return static_cast<std::size_t>(std::count_if(m_life.begin(), m_life.end(), [](float life) { return life > 0.f; }));
+}
+
+float ParticleSystem::random01() {
+    // xorshift32
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return static_cast<float>(m_random >> 8) * (1.f / 16777216.f);
+}
+
+} // namespace systems
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace systems {
+
+// Short-lived visual particles kept outside the ECS in fixed-capacity
+// structure-of-arrays buffers. Spawning writes into a ring slot, so it never
+// allocates; once the ring is full the oldest particle is overwritten.
+class ParticleSystem {
+public:
+    static constexpr std::size_t kDefaultCapacity = 4096;
+
+    explicit ParticleSystem(std::size_t capacity = kDefaultCapacity);
+
+    void clear();
+    void spawn(const sf::Vector2f& position, const sf::Vector2f& velocity, float life, sf::Color color);
+    // `count` particles thrown in random directions at up to `speed` pixels per second.
+    void burst(const sf::Vector2f& position, int count, float speed, float life, sf::Color color);
+    // `count` particles spread evenly on a circle that expands to `radius` over `life`.
+    void ring(const sf::Vector2f& position, float radius, int count, float life, sf::Color color);
+    void update(float dt);
+
+    // Appends one quad per live particle inside `area`, faded by its remaining life.
+    void appendQuads(std::vector<sf::Vertex>& out, const sf::FloatRect& area) const;
+
+    std::size_t capacity() const { return m_life.size(); }
+    std::size_t alive() const;
+
+private:
+    float random01();
+
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_vx;
+    std::vector<float> m_vy;
+    std::vector<float> m_life;
+    std::vector<float> m_invMaxLife;
+    std::vector<sf::Color> m_color;
+    std::size_t m_next = 0;
+    // Slots below m_used have been written since clear(); m_horizon is the time
+    // until the longest-lived particle expires. Together they let update() skip
+    // untouched slots and idle ticks.
+    std::size_t m_used = 0;
+    float m_horizon = 0.f;
+    // Private generator so effects never consume the simulation's random stream.
+    std::uint32_t m_random = 0x9e3779b9u;
+};
+
+} // namespace systems
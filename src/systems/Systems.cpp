@@ -6,6 +6,12 @@ namespace systems {
 
 static std::string towerTargetingMode(ecs::Entity e, ecs::Registry& registry);
 
+namespace {
+const sf::Color kImpactColor(255, 230, 150);
+const sf::Color kSplashColor(255, 150, 60);
+const sf::Color kDeathColor(200, 40, 40);
+} // namespace
+
 void updateMovement(ecs::Registry& registry, const PathContext& pathContext, float dt, float tileSize, int& livesLost) {
     (void)tileSize;
     std::vector<ecs::Entity> toRemove;
@@ -130,7 +136,7 @@ void updateFiring(ecs::Registry& registry, ProjectilePool& pool, float dt, const
     }
 }
 
-void updateProjectiles(ecs::Registry& registry, float dt, const data::BalanceDefinition&) {
+void updateProjectiles(ecs::Registry& registry, ParticleSystem& particles, float dt, const data::BalanceDefinition&) {
     std::vector<ecs::Entity> toDestroy;
     for (auto& [entity, projectile] : registry.m_projectiles) {
         auto& transform = registry.m_transforms[entity];
@@ -167,6 +173,10 @@ void updateProjectiles(ecs::Registry& registry, float dt, const data::BalanceDef
                     }
                 }
             }
+            particles.burst(targetPos, 5, 90.f, 0.25f, kImpactColor);
+            if (projectile.aoeRadius > 0.f) {
+                particles.ring(targetPos, projectile.aoeRadius, 16, 0.35f, kSplashColor);
+            }
             toDestroy.push_back(entity);
             continue;
         }
@@ -214,7 +224,7 @@ void updateStatus(ecs::Registry& registry, float dt, const data::BalanceDefiniti
     }
 }
 
-void updateCleanup(ecs::Registry& registry, ProjectilePool& projectilePool, EffectPool&) {
+void updateCleanup(ecs::Registry& registry, ProjectilePool& projectilePool, ParticleSystem& particles) {
     std::vector<ecs::Entity> toRemove;
     for (auto& [entity, health] : registry.m_health) {
         if (health.hp <= 0.f) {
@@ -226,6 +236,10 @@ void updateCleanup(ecs::Registry& registry, ProjectilePool& projectilePool, Effe
             projectilePool.available.push_back(entity);
             registry.m_projectiles.erase(entity);
         }
+        auto transformIt = registry.m_transforms.find(entity);
+        if (transformIt != registry.m_transforms.end()) {
+            particles.burst(transformIt->second.position, 14, 120.f, 0.5f, kDeathColor);
+        }
         registry.destroy(entity);
     }
 }
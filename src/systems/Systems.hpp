@@ -5,6 +5,7 @@
 #include "../math/Path.hpp"
 #include "../math/SpatialHash.hpp"
 #include "../ecs/Registry.hpp"
+#include "Particles.hpp"
 #include <unordered_map>
 #include <vector>
 
@@ -18,16 +19,12 @@ struct ProjectilePool {
     std::vector<ecs::Entity> available;
 };
 
-struct EffectPool {
-    std::vector<ecs::Entity> available;
-};
-
 void updateMovement(ecs::Registry& registry, const PathContext& pathContext, float dt, float tileSize, int& livesLost);
 void updateTargeting(ecs::Registry& registry, const math::SpatialHashGrid& grid, const std::vector<ecs::Entity>& enemyOrder, float dt);
 void updateFiring(ecs::Registry& registry, ProjectilePool& pool, float dt, const data::BalanceDefinition& balance);
-void updateProjectiles(ecs::Registry& registry, float dt, const data::BalanceDefinition& balance);
+void updateProjectiles(ecs::Registry& registry, ParticleSystem& particles, float dt, const data::BalanceDefinition& balance);
 void updateStatus(ecs::Registry& registry, float dt, const data::BalanceDefinition& balance);
-void updateCleanup(ecs::Registry& registry, ProjectilePool& projectilePool, EffectPool& effectPool);
+void updateCleanup(ecs::Registry& registry, ProjectilePool& projectilePool, ParticleSystem& particles);
 
 } // namespace systems
 
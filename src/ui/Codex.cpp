@@ -1,46 +1,130 @@
 #include "Codex.hpp"
 
+#include <algorithm>
+
 namespace ui {
 
+namespace {
+const sf::Color kTowerColor(255, 255, 255);
+const sf::Color kDetailColor(170, 190, 220);
+const sf::Color kEnemyColor(200, 160, 160);
+
+template <typename Map>
+std::vector<std::string> sortedIds(const Map& map) {
+    std::vector<std::string> ids;
+    ids.reserve(map.size());
+    for (const auto& [id, value] : map) ids.push_back(id);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+std::string number(float value) { return std::to_string(static_cast<int>(value)); }
+} // namespace
+
 void CodexView::init(const sf::Font& font) {
-    m_entries.clear();
-    sf::Text header;
-    header.setFont(font);
-    header.setString("Codex");
-    header.setCharacterSize(28);
-    header.setPosition(420.f, 40.f);
-    header.setFillColor(sf::Color::Yellow);
-    m_entries.push_back(header);
+    m_header.setFont(font);
+    m_header.setString("Codex");
+    m_header.setCharacterSize(28);
+    m_header.setPosition(420.f, 40.f);
+    m_header.setFillColor(sf::Color::Yellow);
+    m_filterLabel.setFont(font);
+    m_filterLabel.setCharacterSize(16);
+    m_filterLabel.setPosition(420.f, 76.f);
+    m_list.init(font, {414.f, 100.f, 600.f, 580.f}, 20.f, 16);
+    updateFilterLabel();
 }
 
 void CodexView::setDatabase(const data::GameDatabase& database) {
-    float y = 90.f;
-    for (const auto& [id, tower] : database.towers) {
-        sf::Text entry = m_entries.front();
-        entry.setString("Tower: " + tower.name + " dmg=" + std::to_string(static_cast<int>(tower.damage)) + " range=" + std::to_string(static_cast<int>(tower.range)));
-        entry.setPosition(420.f, y);
-        entry.setCharacterSize(16);
-        entry.setFillColor(sf::Color::White);
-        m_entries.push_back(entry);
-        y += 20.f;
+    m_database = &database;
+    m_entries.clear();
+    std::vector<ListItem> items;
+    for (const auto& id : sortedIds(database.towers)) {
+        const auto& tower = database.towers.at(id);
+        std::vector<std::string> tags{"tower", tower.role};
+        tags.insert(tags.end(), tower.tags.begin(), tower.tags.end());
+        m_entries.push_back({EntryKind::Tower, id, 0});
+        items.push_back({id, tags});
+        for (std::size_t i = 0; i < tower.upgrades.size(); ++i) {
+            m_entries.push_back({EntryKind::Upgrade, id, i});
+            items.push_back({id, tags});
+        }
+        for (std::size_t branch = 0; branch < 2; ++branch) {
+            if ((branch == 0 ? tower.branchA : tower.branchB).name.empty()) continue;
+            m_entries.push_back({EntryKind::Branch, id, branch});
+            items.push_back({id, tags});
+        }
+    }
+    for (const auto& id : sortedIds(database.enemies)) {
+        const auto& enemy = database.enemies.at(id);
+        std::vector<std::string> tags{"enemy"};
+        tags.insert(tags.end(), enemy.tags.begin(), enemy.tags.end());
+        m_entries.push_back({EntryKind::Enemy, id, 0});
+        items.push_back({id, std::move(tags)});
     }
-    y += 20.f;
-    for (const auto& [id, enemy] : database.enemies) {
-        sf::Text entry = m_entries.front();
-        entry.setString("Enemy: " + enemy.name + " hp=" + std::to_string(static_cast<int>(enemy.hp)) + " speed=" + std::to_string(static_cast<int>(enemy.speed)));
-        entry.setPosition(420.f, y);
-        entry.setCharacterSize(16);
-        entry.setFillColor(sf::Color(200, 160, 160));
-        m_entries.push_back(entry);
-        y += 20.f;
+    m_list.setItems(std::move(items), [this](std::size_t index) { return describe(index); });
+    m_filters = m_list.tags();
+    m_filters.insert(m_filters.begin(), std::string());
+    m_filterIndex = 0;
+    m_list.setFilter({});
+    updateFilterLabel();
+}
+
+ListRow CodexView::describe(std::size_t index) const {
+    const Entry& entry = m_entries[index];
+    if (entry.kind == EntryKind::Enemy) {
+        auto it = m_database->enemies.find(entry.id);
+        if (it == m_database->enemies.end()) return {entry.id, kEnemyColor};
+        const auto& enemy = it->second;
+        return {"Enemy: " + enemy.name + " hp=" + number(enemy.hp) + " speed=" + number(enemy.speed) +
+                    " armor=" + number(enemy.armor),
+                kEnemyColor};
+    }
+    auto it = m_database->towers.find(entry.id);
+    if (it == m_database->towers.end()) return {entry.id, kTowerColor};
+    const auto& tower = it->second;
+    switch (entry.kind) {
+        case EntryKind::Upgrade: {
+            const auto& upgrade = tower.upgrades[entry.detail];
+            return {"    Lv " + std::to_string(upgrade.level) + ": dmg +" + number(upgrade.damage) + " range +" +
+                        number(upgrade.range),
+                    kDetailColor};
+        }
+        case EntryKind::Branch: {
+            const auto& branch = entry.detail == 0 ? tower.branchA : tower.branchB;
+            return {std::string("    Branch ") + (entry.detail == 0 ? "A" : "B") + ": " + branch.name, kDetailColor};
+        }
+        default:
+            return {"Tower: " + tower.name + " [" + tower.role + "] dmg=" + number(tower.damage) + " range=" +
+                        number(tower.range) + " cost=" + std::to_string(tower.cost),
+                    kTowerColor};
     }
 }
 
-void CodexView::draw(sf::RenderWindow& window) const {
-    for (const auto& entry : m_entries) {
-        window.draw(entry);
+void CodexView::handleEvent(const sf::Event& event) {
+    if (event.type == sf::Event::MouseWheelScrolled) {
+        m_list.scroll(-event.mouseWheelScroll.delta * 3.f);
+    } else if (event.type == sf::Event::KeyPressed) {
+        if (event.key.code == sf::Keyboard::Tab && !m_filters.empty()) {
+            m_filterIndex = (m_filterIndex + 1) % m_filters.size();
+            m_list.setFilter(m_filters[m_filterIndex]);
+            updateFilterLabel();
+        } else if (event.key.code == sf::Keyboard::PageDown) {
+            m_list.scroll(20.f);
+        } else if (event.key.code == sf::Keyboard::PageUp) {
+            m_list.scroll(-20.f);
+        }
     }
 }
 
-} // namespace ui
+void CodexView::updateFilterLabel() {
+    const std::string filter = m_list.filter().empty() ? "all" : m_list.filter();
+    m_filterLabel.setString("Filter: " + filter + " (" + std::to_string(m_list.size()) + ")   Tab: next filter");
+}
+
+void CodexView::draw(sf::RenderWindow& window) {
+    window.draw(m_header);
+    window.draw(m_filterLabel);
+    m_list.draw(window);
+}
 
+} // namespace ui
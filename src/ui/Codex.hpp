@@ -1,5 +1,6 @@
 #pragma once
 
+#include "VirtualList.hpp"
 #include "../core/GameData.hpp"
 #include <SFML/Graphics.hpp>
 
@@ -8,12 +9,31 @@ namespace ui {
 class CodexView {
 public:
     void init(const sf::Font& font);
+    // Only ids and tags are collected here; row text is formatted from
+    // `database` as rows scroll into view, so it must outlive the view.
     void setDatabase(const data::GameDatabase& database);
-    void draw(sf::RenderWindow& window) const;
+    // Mouse wheel scrolls, Tab cycles the tag/role filter.
+    void handleEvent(const sf::Event& event);
+    void draw(sf::RenderWindow& window);
 
 private:
-    std::vector<sf::Text> m_entries;
+    enum class EntryKind { Tower, Upgrade, Branch, Enemy };
+    struct Entry {
+        EntryKind kind;
+        std::string id;
+        std::size_t detail = 0; // upgrade index, or 0/1 for branch A/B
+    };
+
+    ListRow describe(std::size_t index) const;
+    void updateFilterLabel();
+
+    const data::GameDatabase* m_database = nullptr;
+    std::vector<Entry> m_entries;
+    std::vector<std::string> m_filters; // "" first, meaning everything
+    std::size_t m_filterIndex = 0;
+    VirtualList m_list;
+    sf::Text m_header;
+    sf::Text m_filterLabel;
 };
 
 } // namespace ui
-
@@ -1,40 +1,135 @@
 #include "HUD.hpp"
 
+#include "../core/Profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
 namespace ui {
 
+namespace {
+constexpr unsigned kCharacterSize = 18;
+constexpr float kLeft = 10.f;
+constexpr float kValueX = 80.f;
+constexpr float kRowHeight = 30.f;
+constexpr float kBarX = 150.f;
+constexpr float kBarWidth = 120.f;
+constexpr float kBarHeight = 10.f;
+constexpr float kLabelWidth = kBarX + kBarWidth + 2.f;
+constexpr float kLabelHeight = 4.f * kRowHeight + 4.f;
+const char* const kLabelNames[] = {"Lives", "Coins", "Wave", "Speed"};
+
+float rowY(int row) { return kLeft + kRowHeight * static_cast<float>(row); }
+
+void setupText(sf::Text& text, const sf::Font& font, float x, float y) {
+    text.setFont(font);
+    text.setCharacterSize(kCharacterSize);
+    text.setPosition(x, y);
+}
+
+float ratio(float value, float max) { return max > 0.f ? std::clamp(value / max, 0.f, 1.f) : 0.f; }
+} // namespace
+
 void HUD::init(const sf::Font& font) {
-    m_lives.setFont(font);
-    m_coins.setFont(font);
-    m_wave.setFont(font);
-    m_speed.setFont(font);
-    m_state.setFont(font);
-    m_lives.setCharacterSize(18);
-    m_coins.setCharacterSize(18);
-    m_wave.setCharacterSize(18);
-    m_speed.setCharacterSize(18);
-    m_state.setCharacterSize(18);
-    m_lives.setPosition(10.f, 10.f);
-    m_coins.setPosition(10.f, 40.f);
-    m_wave.setPosition(10.f, 70.f);
-    m_speed.setPosition(10.f, 100.f);
-    m_state.setPosition(10.f, 130.f);
+    for (std::size_t i = 0; i < m_labels.size(); ++i) {
+        setupText(m_labels[i], font, kLeft, rowY(static_cast<int>(i)));
+        m_labels[i].setString(kLabelNames[i]);
+    }
+    setupText(m_lives, font, kValueX, rowY(0));
+    setupText(m_coins, font, kValueX, rowY(1));
+    setupText(m_wave, font, kValueX, rowY(2));
+    setupText(m_speed, font, kValueX, rowY(3));
+    setupText(m_state, font, kLeft, rowY(4));
+    setupText(m_towerName, font, kLeft, rowY(5) + 10.f);
+    setupText(m_towerStats, font, kLeft, rowY(6) + 10.f);
+
+    m_livesBar.setPosition(kBarX, rowY(0) + 7.f);
+    m_livesBar.setFillColor(sf::Color(200, 50, 50));
+    m_waveBar.setPosition(kBarX, rowY(2) + 7.f);
+    m_waveBar.setFillColor(sf::Color(220, 190, 60));
+
+    m_labelsBaked = false;
+    m_bakeFailed = false;
+    m_hasShown = false;
 }
 
-void HUD::update(int lives, int coins, int wave, float speed, bool paused) {
-    m_lives.setString("Lives: " + std::to_string(lives));
-    m_coins.setString("Coins: " + std::to_string(coins));
-    m_wave.setString("Wave: " + std::to_string(wave));
-    m_speed.setString("Speed: " + std::to_string(static_cast<int>(speed)) + "x");
-    m_state.setString(paused ? "Paused" : "Running");
+void HUD::update(const HudValues& values) {
+    TD_PROFILE_SCOPE("HUD::update");
+    const bool all = !m_hasShown;
+    if (all || values.lives != m_shown.lives || values.maxLives != m_shown.maxLives) {
+        m_lives.setString(std::to_string(values.lives));
+        m_livesBar.setSize({kBarWidth * ratio(static_cast<float>(values.lives), static_cast<float>(values.maxLives)), kBarHeight});
+    }
+    if (all || values.coins != m_shown.coins) {
+        m_coins.setString(std::to_string(values.coins));
+    }
+    if (all || values.wave != m_shown.wave || values.waveCount != m_shown.waveCount) {
+        m_wave.setString(std::to_string(values.wave) + "/" + std::to_string(values.waveCount));
+    }
+    if (all || values.waveProgress != m_shown.waveProgress) {
+        m_waveBar.setSize({kBarWidth * ratio(values.waveProgress, 1.f), kBarHeight});
+    }
+    if (all || values.speed != m_shown.speed) {
+        m_speed.setString(std::to_string(values.speed) + "x");
+    }
+    if (all || values.paused != m_shown.paused) {
+        m_state.setString(values.paused ? "Paused" : "Running");
+    }
+    if (values.showTower && (all || !m_shown.showTower || !(values.tower == m_shown.tower))) {
+        const HudTowerInfo& tower = values.tower;
+        char buffer[96];
+        std::snprintf(buffer, sizeof(buffer), "Lv %d  Dmg %.0f  Rng %.0f  %.1f/s", tower.level, tower.damage, tower.range,
+                      tower.fireRate);
+        m_towerName.setString(tower.name);
+        m_towerStats.setString(buffer);
+    }
+    m_shown = values;
+    m_hasShown = true;
+}
+
+void HUD::bakeLabels() {
+    m_labelsBaked = true;
+    if (!m_labelTexture.create(static_cast<unsigned>(kLabelWidth), static_cast<unsigned>(kLabelHeight))) {
+        std::cerr << "[HUD] Render texture unavailable; drawing labels directly" << std::endl;
+        m_bakeFailed = true;
+        return;
+    }
+    m_labelTexture.clear(sf::Color::Transparent);
+    for (const auto& label : m_labels) {
+        m_labelTexture.draw(label);
+    }
+    // Bar tracks, so the filled part reads against a fixed frame.
+    for (int row : {0, 2}) {
+        sf::RectangleShape track({kBarWidth, kBarHeight});
+        track.setPosition(kBarX, rowY(row) + 7.f);
+        track.setFillColor(sf::Color(40, 40, 40, 200));
+        track.setOutlineColor(sf::Color(120, 120, 120));
+        track.setOutlineThickness(1.f);
+        m_labelTexture.draw(track);
+    }
+    m_labelTexture.display();
+    m_labelSprite.setTexture(m_labelTexture.getTexture(), true);
 }
 
 void HUD::draw(sf::RenderWindow& window) {
+    TD_PROFILE_SCOPE("HUD::draw");
+    if (!m_labelsBaked) bakeLabels();
+    if (m_bakeFailed) {
+        for (const auto& label : m_labels) window.draw(label);
+    } else {
+        window.draw(m_labelSprite);
+    }
+    window.draw(m_livesBar);
+    window.draw(m_waveBar);
     window.draw(m_lives);
     window.draw(m_coins);
     window.draw(m_wave);
     window.draw(m_speed);
     window.draw(m_state);
+    if (m_shown.showTower) {
+        window.draw(m_towerName);
+        window.draw(m_towerStats);
+    }
 }
 
 } // namespace ui
-
@@ -1,23 +1,64 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <array>
 #include <string>
 
 namespace ui {
 
+struct HudTowerInfo {
+    std::string name;
+    int level = 0;
+    float damage = 0.f;
+    float fireRate = 0.f;
+    float range = 0.f;
+
+    bool operator==(const HudTowerInfo&) const = default;
+};
+
+struct HudValues {
+    int lives = 0;
+    int maxLives = 0;
+    int coins = 0;
+    int wave = 0;
+    int waveCount = 0;
+    float waveProgress = 0.f; // share of the current wave's enemies already resolved
+    int speed = 1;
+    bool paused = false;
+    bool showTower = false; // the cursor is over a placed tower
+    HudTowerInfo tower;
+};
+
+// Retained HUD: update() compares against the values currently on screen and
+// only calls setString on texts whose value changed, so an idle HUD costs no
+// glyph layout. Static labels are baked once into a render texture.
 class HUD {
 public:
     void init(const sf::Font& font);
-    void update(int lives, int coins, int wave, float speed, bool paused);
+    void update(const HudValues& values);
     void draw(sf::RenderWindow& window);
 
 private:
+    void bakeLabels();
+
+    std::array<sf::Text, 4> m_labels;
+    sf::RenderTexture m_labelTexture;
+    sf::Sprite m_labelSprite;
+    bool m_labelsBaked = false;
+    bool m_bakeFailed = false;
+
     sf::Text m_lives;
     sf::Text m_coins;
     sf::Text m_wave;
     sf::Text m_speed;
     sf::Text m_state;
+    sf::Text m_towerName;
+    sf::Text m_towerStats;
+    sf::RectangleShape m_livesBar;
+    sf::RectangleShape m_waveBar;
+
+    HudValues m_shown;
+    bool m_hasShown = false;
 };
 
 } // namespace ui
-
@@ -1,56 +1,114 @@
 #include "LevelSelect.hpp"
 
+#include <algorithm>
+
 namespace ui {
 
+namespace {
+const sf::FloatRect kListBounds(80.f, 120.f, 480.f, 540.f);
+const sf::Vector2f kThumbnailSize(96.f, 54.f);
+} // namespace
+
 void LevelSelect::init(const sf::Font& font) {
-    m_font = &font;
-    m_entries.clear();
-}
-
-void LevelSelect::setLevels(const std::map<std::string, std::string>& levels) {
-    m_entries.clear();
-    float y = 120.f;
-    for (const auto& [id, name] : levels) {
-        sf::RectangleShape rect({300.f, 32.f});
-        rect.setPosition({80.f, y});
-        rect.setFillColor(sf::Color(40, 40, 70));
-        rect.setOutlineColor(sf::Color::White);
-        rect.setOutlineThickness(1.f);
-        sf::Text text;
-        if (m_font) text.setFont(*m_font);
-        text.setString(name + " (" + id + ")");
-        text.setPosition({90.f, y + 6.f});
-        text.setFillColor(sf::Color::White);
-        text.setCharacterSize(18);
-        m_entries.emplace_back(rect, text);
-        y += 40.f;
+    m_list.init(font, kListBounds, 60.f, 18, kThumbnailSize);
+    m_panel.setPosition(kListBounds.left, kListBounds.top);
+    m_panel.setSize({kListBounds.width, kListBounds.height});
+    m_panel.setFillColor(sf::Color(40, 40, 70));
+    m_panel.setOutlineColor(sf::Color::White);
+    m_panel.setOutlineThickness(1.f);
+    m_filterLabel.setFont(font);
+    m_filterLabel.setCharacterSize(16);
+    m_filterLabel.setPosition(kListBounds.left, kListBounds.top - 28.f);
+    updateFilterLabel();
+}
+
+void LevelSelect::setLevels(const std::vector<data::LevelHeader>& levels) {
+    m_levels = &levels;
+    m_hovered.clear();
+    std::vector<std::size_t> order(levels.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return levels[a].id < levels[b].id; });
+    m_ids.clear();
+    std::vector<ListItem> items;
+    items.reserve(levels.size());
+    for (std::size_t index : order) {
+        m_ids.push_back(levels[index].id);
+        items.push_back({levels[index].id, {levels[index].biome}});
     }
+    m_thumbnailSettled.assign(m_ids.size(), false);
+    m_list.setItems(std::move(items), [this, order = std::move(order)](std::size_t index) {
+        const std::string& id = m_ids[index];
+        ListRow row{(*m_levels)[order[index]].name + " (" + id + ")"};
+        if (m_thumbnails) {
+            bool failed = false;
+            row.icon = m_thumbnails(id, failed);
+            if (row.icon || failed) m_thumbnailSettled[index] = true;
+        }
+        return row;
+    });
+    m_filters = m_list.tags();
+    m_filters.insert(m_filters.begin(), std::string());
+    m_filterIndex = 0;
+    m_list.setFilter({});
+    updateFilterLabel();
+}
+
+void LevelSelect::setThumbnailSource(ThumbnailSource source) {
+    m_thumbnails = std::move(source);
 }
 
 void LevelSelect::setOnSelect(std::function<void(const std::string&)> cb) { m_callback = std::move(cb); }
 
-void LevelSelect::draw(sf::RenderWindow& window) const {
-    for (const auto& entry : m_entries) {
-        window.draw(entry.first);
-        window.draw(entry.second);
-    }
+void LevelSelect::setOnHover(std::function<void(const std::string&)> cb) { m_hoverCallback = std::move(cb); }
+
+void LevelSelect::draw(sf::RenderWindow& window) {
+    pollThumbnails();
+    window.draw(m_filterLabel);
+    window.draw(m_panel);
+    m_list.draw(window);
 }
 
 void LevelSelect::handleClick(const sf::Vector2f& point) const {
-    for (const auto& entry : m_entries) {
-        if (entry.first.getGlobalBounds().contains(point)) {
-            if (m_callback) {
-                std::string id = entry.second.getString();
-                auto pos = id.find('(');
-                if (pos != std::string::npos) {
-                    std::string levelId = id.substr(pos + 1);
-                    if (!levelId.empty() && levelId.back() == ')') levelId.pop_back();
-                    m_callback(levelId);
-                }
-            }
+    if (!m_callback) return;
+    if (const std::string* id = m_list.keyAt(point)) m_callback(*id);
+}
+
+void LevelSelect::handleHover(const sf::Vector2f& point) {
+    const std::string* id = m_list.keyAt(point);
+    if (!id || *id == m_hovered) return;
+    m_hovered = *id;
+    if (m_hoverCallback) m_hoverCallback(m_hovered);
+}
+
+void LevelSelect::handleEvent(const sf::Event& event) {
+    if (event.type == sf::Event::MouseWheelScrolled) {
+        m_list.scroll(-event.mouseWheelScroll.delta);
+    } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Tab && !m_filters.empty()) {
+        m_filterIndex = (m_filterIndex + 1) % m_filters.size();
+        m_list.setFilter(m_filters[m_filterIndex]);
+        updateFilterLabel();
+    }
+}
+
+void LevelSelect::pollThumbnails() {
+    if (!m_thumbnails) return;
+    // Rows described before their thumbnail finished show a placeholder; describe them again once it exists.
+    // Only rows in view are asked about, and a failed thumbnail is never asked about again.
+    for (std::size_t index : m_list.visibleItems()) {
+        if (m_thumbnailSettled[index]) continue;
+        bool failed = false;
+        if (m_thumbnails(m_ids[index], failed)) {
+            m_list.invalidate(index);
+        } else if (!failed) {
+            continue;
         }
+        m_thumbnailSettled[index] = true;
     }
 }
 
-} // namespace ui
+void LevelSelect::updateFilterLabel() {
+    const std::string filter = m_list.filter().empty() ? "all" : m_list.filter();
+    m_filterLabel.setString("Biome: " + filter + " (" + std::to_string(m_list.size()) + ")   Tab: next biome");
+}
 
+} // namespace ui
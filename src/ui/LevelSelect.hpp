@@ -1,25 +1,48 @@
 #pragma once
 
+#include "VirtualList.hpp"
+#include "../core/GameData.hpp"
 #include <SFML/Graphics.hpp>
 #include <functional>
-#include <map>
 #include <string>
+#include <vector>
 
 namespace ui {
 
 class LevelSelect {
 public:
     void init(const sf::Font& font);
-    void setLevels(const std::map<std::string, std::string>& levels);
+    // Row text is built from `levels` on first view, so it must outlive the screen.
+    void setLevels(const std::vector<data::LevelHeader>& levels);
+    // Returns a level's preview, or nullptr while it is still being generated;
+    // sets `failed` for a level that will never have one.
+    using ThumbnailSource = std::function<const sf::Texture*(const std::string& id, bool& failed)>;
+    void setThumbnailSource(ThumbnailSource source);
     void setOnSelect(std::function<void(const std::string&)> cb);
-    void draw(sf::RenderWindow& window) const;
+    // Called once each time the pointer moves onto another level's row.
+    void setOnHover(std::function<void(const std::string&)> cb);
+    void draw(sf::RenderWindow& window);
     void handleClick(const sf::Vector2f& point) const;
+    void handleHover(const sf::Vector2f& point);
+    // Mouse wheel scrolls, Tab cycles the biome filter.
+    void handleEvent(const sf::Event& event);
 
 private:
-    std::vector<std::pair<sf::RectangleShape, sf::Text>> m_entries;
+    void updateFilterLabel();
+    void pollThumbnails();
+
+    const std::vector<data::LevelHeader>* m_levels = nullptr;
+    std::vector<std::string> m_ids; // sorted
+    ThumbnailSource m_thumbnails;
+    std::vector<bool> m_thumbnailSettled; // per index into m_ids: shown or failed, no longer polled
+    std::vector<std::string> m_filters; // "" first, meaning every biome
+    std::size_t m_filterIndex = 0;
+    VirtualList m_list;
+    sf::RectangleShape m_panel;
+    sf::Text m_filterLabel;
     std::function<void(const std::string&)> m_callback;
-    const sf::Font* m_font = nullptr;
+    std::function<void(const std::string&)> m_hoverCallback;
+    std::string m_hovered;
 };
 
 } // namespace ui
-
@@ -0,0 +1,103 @@
+#include "ProfilerOverlay.hpp"
+
+#if TD_PROFILER
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+namespace ui {
+
+namespace {
+constexpr float kPanelX = 880.f;
+constexpr float kPanelY = 10.f;
+constexpr float kPanelWidth = 390.f;
+constexpr float kGraphHeight = 80.f;
+constexpr float kGraphMaxMs = 33.3f;
+constexpr float kBudgetMs = 1000.f / 60.f;
+constexpr std::size_t kTopAllocators = 5;
+} // namespace
+
+void ProfilerOverlay::init(const sf::Font& font) {
+    m_background.setFillColor(sf::Color(0, 0, 0, 180));
+    m_background.setPosition(kPanelX, kPanelY);
+    m_text.setFont(font);
+    m_text.setCharacterSize(13);
+    m_text.setFillColor(sf::Color(220, 220, 220));
+    m_text.setPosition(kPanelX + 8.f, kPanelY + kGraphHeight + 12.f);
+    m_graph.setPrimitiveType(sf::Quads);
+}
+
+void ProfilerOverlay::update(const core::Profiler& profiler, const ecs::Registry* registry) {
+    if (!m_visible) return;
+
+    const auto frames = profiler.frameTimes();
+    const float barWidth = (kPanelWidth - 16.f) / static_cast<float>(frames.size());
+    const float baseY = kPanelY + 8.f + kGraphHeight;
+    m_graph.resize(frames.size() * 4 + 4);
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        const float height = std::min(frames[i], kGraphMaxMs) / kGraphMaxMs * kGraphHeight;
+        const float x = kPanelX + 8.f + barWidth * static_cast<float>(i);
+        const sf::Color color = frames[i] > kBudgetMs ? sf::Color(230, 80, 60) : sf::Color(90, 200, 110);
+        sf::Vertex* quad = &m_graph[i * 4];
+        quad[0] = sf::Vertex({x, baseY - height}, color);
+        quad[1] = sf::Vertex({x + barWidth, baseY - height}, color);
+        quad[2] = sf::Vertex({x + barWidth, baseY}, color);
+        quad[3] = sf::Vertex({x, baseY}, color);
+    }
+    // 60 FPS budget line.
+    const float budgetY = baseY - kBudgetMs / kGraphMaxMs * kGraphHeight;
+    sf::Vertex* line = &m_graph[frames.size() * 4];
+    const sf::Color lineColor(255, 255, 255, 120);
+    line[0] = sf::Vertex({kPanelX + 8.f, budgetY}, lineColor);
+    line[1] = sf::Vertex({kPanelX + kPanelWidth - 8.f, budgetY}, lineColor);
+    line[2] = sf::Vertex({kPanelX + kPanelWidth - 8.f, budgetY + 1.f}, lineColor);
+    line[3] = sf::Vertex({kPanelX + 8.f, budgetY + 1.f}, lineColor);
+
+    char buffer[96];
+    std::string text;
+    const auto& frameAllocations = profiler.lastFrameAllocations();
+    std::snprintf(buffer, sizeof(buffer), "frame %.2f ms  %llu allocs  %.1f KB   (F4: dump CSV)\n",
+                  profiler.lastFrameMs(), static_cast<unsigned long long>(frameAllocations.count),
+                  static_cast<double>(frameAllocations.bytes) / 1024.0);
+    text += buffer;
+    std::snprintf(buffer, sizeof(buffer), "%-22s %7s %7s %5s %6s\n", "scope", "avg", "max", "n", "alloc");
+    text += buffer;
+    auto scopes = profiler.scopes();
+    std::sort(scopes.begin(), scopes.end(),
+              [](const core::ProfileScopeStats& a, const core::ProfileScopeStats& b) { return a.averageMs > b.averageMs; });
+    for (const auto& scope : scopes) {
+        std::snprintf(buffer, sizeof(buffer), "%-22.22s %7.3f %7.3f %5u %6u\n", scope.name, scope.averageMs,
+                      scope.maxMs, scope.calls, scope.allocations);
+        text += buffer;
+    }
+    // Allocation sites are tagged with the innermost scope, so self counts rank them.
+    std::sort(scopes.begin(), scopes.end(), [](const core::ProfileScopeStats& a, const core::ProfileScopeStats& b) {
+        return a.averageSelfAllocations > b.averageSelfAllocations;
+    });
+    text += "top allocators (self allocs/frame)\n";
+    for (std::size_t i = 0; i < std::min<std::size_t>(kTopAllocators, scopes.size()); ++i) {
+        if (scopes[i].averageSelfAllocations < 0.05f) break;
+        std::snprintf(buffer, sizeof(buffer), "  %-22.22s %8.1f\n", scopes[i].name, scopes[i].averageSelfAllocations);
+        text += buffer;
+    }
+    if (registry) {
+        std::snprintf(buffer, sizeof(buffer), "entities %zu  enemies %zu  towers %zu  projectiles %zu\n",
+                      registry->m_transforms.size(), registry->m_enemyStats.size(), registry->m_towerStats.size(),
+                      registry->m_projectiles.size());
+        text += buffer;
+    }
+    m_text.setString(text);
+    m_background.setSize({kPanelWidth, kGraphHeight + 24.f + m_text.getLocalBounds().height});
+}
+
+void ProfilerOverlay::draw(sf::RenderWindow& window) const {
+    if (!m_visible) return;
+    window.draw(m_background);
+    window.draw(m_graph);
+    window.draw(m_text);
+}
+
+} // namespace ui
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "../core/Profiler.hpp"
+
+#if TD_PROFILER
+
+#include "../ecs/Registry.hpp"
+#include <SFML/Graphics.hpp>
+
+namespace ui {
+
+// Rolling per-scope timings, a frame-time graph and entity counts (F3 in game).
+class ProfilerOverlay {
+public:
+    void init(const sf::Font& font);
+    void toggle() { m_visible = !m_visible; }
+    bool visible() const { return m_visible; }
+
+    // `registry` may be null outside of gameplay.
+    void update(const core::Profiler& profiler, const ecs::Registry* registry);
+    void draw(sf::RenderWindow& window) const;
+
+private:
+    bool m_visible = false;
+    sf::RectangleShape m_background;
+    sf::Text m_text;
+    sf::VertexArray m_graph;
+};
+
+} // namespace ui
+
+#endif
@@ -0,0 +1,171 @@
+#include "VirtualList.hpp"
+
+#include "../core/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace ui {
+
+namespace {
+constexpr std::size_t kNoItem = std::numeric_limits<std::size_t>::max();
+constexpr float kTextInset = 6.f;
+} // namespace
+
+void VirtualList::init(const sf::Font& font, const sf::FloatRect& bounds, float rowHeight, unsigned characterSize,
+                       const sf::Vector2f& iconSize) {
+    m_font = &font;
+    m_bounds = bounds;
+    m_rowHeight = rowHeight;
+    m_characterSize = characterSize;
+    m_iconSize = iconSize;
+    m_iconPlaceholder.setSize(iconSize);
+    m_iconPlaceholder.setFillColor(sf::Color(70, 70, 90));
+    const auto slots = static_cast<std::size_t>(std::ceil(bounds.height / rowHeight)) + 1;
+    m_texts.assign(slots, sf::Text());
+    for (auto& text : m_texts) {
+        text.setFont(font);
+        text.setCharacterSize(characterSize);
+    }
+    m_textItems.assign(slots, kNoItem);
+    m_cacheReady = false;
+    m_cacheFailed = false;
+    m_dirty = true;
+}
+
+void VirtualList::setItems(std::vector<ListItem> items, Describe describe) {
+    m_items = std::move(items);
+    m_describe = std::move(describe);
+    m_rows.assign(m_items.size(), ListRow{});
+    m_described.assign(m_items.size(), false);
+    m_describedCount = 0;
+    std::fill(m_textItems.begin(), m_textItems.end(), kNoItem);
+    m_scroll = 0.f;
+    setFilter(m_filter);
+}
+
+void VirtualList::invalidate(std::size_t item) {
+    if (item >= m_items.size() || !m_described[item]) return;
+    m_described[item] = false;
+    --m_describedCount;
+    std::replace(m_textItems.begin(), m_textItems.end(), item, kNoItem);
+    m_dirty = true;
+}
+
+void VirtualList::setFilter(const std::string& tag) {
+    m_filter = tag;
+    m_filtered.clear();
+    for (std::size_t i = 0; i < m_items.size(); ++i) {
+        const auto& tags = m_items[i].tags;
+        if (tag.empty() || std::find(tags.begin(), tags.end(), tag) != tags.end()) m_filtered.push_back(i);
+    }
+    clampScroll();
+    m_dirty = true;
+}
+
+std::vector<std::string> VirtualList::tags() const {
+    std::vector<std::string> out;
+    for (const auto& item : m_items) {
+        for (const auto& tag : item.tags) {
+            if (std::find(out.begin(), out.end(), tag) == out.end()) out.push_back(tag);
+        }
+    }
+    return out;
+}
+
+void VirtualList::scroll(float rows) {
+    const float before = m_scroll;
+    m_scroll += rows * m_rowHeight;
+    clampScroll();
+    if (m_scroll != before) m_dirty = true;
+}
+
+void VirtualList::clampScroll() {
+    const float content = static_cast<float>(m_filtered.size()) * m_rowHeight;
+    m_scroll = std::clamp(m_scroll, 0.f, std::max(0.f, content - m_bounds.height));
+}
+
+const std::string* VirtualList::keyAt(const sf::Vector2f& point) const {
+    if (!m_bounds.contains(point)) return nullptr;
+    const auto position = static_cast<std::size_t>((point.y - m_bounds.top + m_scroll) / m_rowHeight);
+    if (position >= m_filtered.size()) return nullptr;
+    return &m_items[m_filtered[position]].key;
+}
+
+const ListRow& VirtualList::row(std::size_t item) {
+    if (!m_described[item]) {
+        if (m_describe) m_rows[item] = m_describe(item);
+        m_described[item] = true;
+        ++m_describedCount;
+    }
+    return m_rows[item];
+}
+
+std::span<const std::size_t> VirtualList::visibleItems() const {
+    const std::size_t first = std::min(m_filtered.size(), static_cast<std::size_t>(m_scroll / m_rowHeight));
+    const std::size_t last = std::min(m_filtered.size(), first + m_texts.size());
+    return std::span<const std::size_t>(m_filtered).subspan(first, last - first);
+}
+
+void VirtualList::render(sf::RenderTarget& target, const sf::Vector2f& offset) {
+    if (m_texts.empty()) return;
+    const auto first = static_cast<std::size_t>(m_scroll / m_rowHeight);
+    const std::size_t last = std::min(m_filtered.size(), first + m_texts.size());
+    for (std::size_t position = first; position < last; ++position) {
+        const std::size_t item = m_filtered[position];
+        const std::size_t slot = position % m_texts.size();
+        sf::Text& text = m_texts[slot];
+        const ListRow& data = row(item);
+        if (m_textItems[slot] != item) {
+            text.setString(data.text);
+            text.setFillColor(data.color);
+            m_textItems[slot] = item;
+        }
+        const float top = offset.y + static_cast<float>(position) * m_rowHeight - m_scroll;
+        float textX = offset.x + kTextInset;
+        if (m_iconSize.x > 0.f) {
+            const sf::Vector2f iconPosition{textX, top + (m_rowHeight - m_iconSize.y) * 0.5f};
+            if (data.icon) {
+                m_icon.setTexture(*data.icon, true);
+                m_icon.setPosition(iconPosition);
+                target.draw(m_icon);
+            } else {
+                m_iconPlaceholder.setPosition(iconPosition);
+                target.draw(m_iconPlaceholder);
+            }
+            textX += m_iconSize.x + kTextInset;
+        }
+        text.setPosition(textX, top);
+        target.draw(text);
+    }
+}
+
+void VirtualList::draw(sf::RenderTarget& target) {
+    TD_PROFILE_SCOPE("VirtualList::draw");
+    if (!m_font) return;
+    if (!m_cacheReady && !m_cacheFailed) {
+        if (m_cache.create(static_cast<unsigned>(m_bounds.width), static_cast<unsigned>(m_bounds.height))) {
+            m_cacheReady = true;
+            m_sprite.setTexture(m_cache.getTexture(), true);
+            m_sprite.setPosition(m_bounds.left, m_bounds.top);
+        } else {
+            std::cerr << "[VirtualList] Render texture unavailable; drawing rows directly" << std::endl;
+            m_cacheFailed = true;
+        }
+    }
+    if (m_cacheFailed) {
+        // Without a clip rectangle, rows that are partly scrolled out stay fully visible here.
+        render(target, {m_bounds.left, m_bounds.top});
+        return;
+    }
+    if (m_dirty) {
+        m_cache.clear(sf::Color::Transparent);
+        render(m_cache, {0.f, 0.f});
+        m_cache.display();
+        m_dirty = false;
+    }
+    target.draw(m_sprite);
+}
+
+} // namespace ui
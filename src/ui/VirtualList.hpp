@@ -0,0 +1,88 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ui {
+
+struct ListItem {
+    std::string key;               // handed back by keyAt(), e.g. a level id
+    std::vector<std::string> tags; // matched by setFilter()
+};
+
+struct ListRow {
+    std::string text;
+    sf::Color color = sf::Color(255, 255, 255);
+    // Drawn left of the text when the list has an icon size; a placeholder box while null.
+    const sf::Texture* icon = nullptr;
+};
+
+// Scrollable list that only lays out the rows currently in view. Row text is
+// produced by the describe callback the first time a row scrolls into view and
+// cached from then on. Visible rows are rendered into a texture that is only
+// redrawn after scrolling, filtering or new items, so an idle list is one
+// sprite per frame.
+class VirtualList {
+public:
+    using Describe = std::function<ListRow(std::size_t item)>;
+
+    void init(const sf::Font& font, const sf::FloatRect& bounds, float rowHeight, unsigned characterSize,
+              const sf::Vector2f& iconSize = {});
+    void setItems(std::vector<ListItem> items, Describe describe);
+    // Describes `item` again the next time it is in view, e.g. once its icon is ready.
+    void invalidate(std::size_t item);
+    // Shows only items carrying `tag`; an empty tag shows everything.
+    void setFilter(const std::string& tag);
+    const std::string& filter() const { return m_filter; }
+    // Distinct tags over all items, in first-seen order.
+    std::vector<std::string> tags() const;
+
+    void scroll(float rows);
+    // Key of the item under `point`, or nullptr.
+    const std::string* keyAt(const sf::Vector2f& point) const;
+    void draw(sf::RenderTarget& target);
+
+    // Items in view, top to bottom.
+    std::span<const std::size_t> visibleItems() const;
+
+    std::size_t size() const { return m_filtered.size(); }
+    std::size_t describedRows() const { return m_describedCount; }
+
+private:
+    const ListRow& row(std::size_t item);
+    void clampScroll();
+    void render(sf::RenderTarget& target, const sf::Vector2f& offset);
+
+    const sf::Font* m_font = nullptr;
+    sf::FloatRect m_bounds;
+    float m_rowHeight = 20.f;
+    unsigned m_characterSize = 16;
+    sf::Vector2f m_iconSize;
+
+    std::vector<ListItem> m_items;
+    Describe m_describe;
+    std::vector<ListRow> m_rows;
+    std::vector<bool> m_described;
+    std::size_t m_describedCount = 0;
+
+    std::string m_filter;
+    std::vector<std::size_t> m_filtered; // item indices passing the filter
+    float m_scroll = 0.f;                // pixels
+
+    // One text per on-screen row; a row keeps its slot while it stays in view.
+    std::vector<sf::Text> m_texts;
+    std::vector<std::size_t> m_textItems;
+    sf::Sprite m_icon;
+    sf::RectangleShape m_iconPlaceholder;
+
+    sf::RenderTexture m_cache;
+    sf::Sprite m_sprite;
+    bool m_cacheReady = false;
+    bool m_cacheFailed = false;
+    bool m_dirty = true;
+};
+
+} // namespace ui
@@ -0,0 +1,283 @@
+// Headless Monte Carlo balance sweep.
+//
+// Usage: towerdefense_sweep <spec.json> [--data DIR] [--out FILE.csv] [--threads N] [--metrics FILE.csv]
+//
+// The spec lists levels, tower layouts and enemy multipliers; every combination
+// is simulated once on a worker pool sharing one GameDatabase. See
+// data/sweeps/example.json.
+//
+// Nothing in the simulation draws random numbers yet, so every seed would give
+// the same run: a spec's `seeds` is accepted but only one run per combination
+// is made.
+
+#include "core/DataLoader.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Simulation.hpp"
+#include "core/Trace.hpp"
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using nlohmann::json;
+
+struct TowerOrder {
+    std::string towerId;
+    sf::Vector2i cell;
+};
+
+struct Layout {
+    std::string name;
+    std::string fillTower;
+    std::vector<TowerOrder> towers;
+};
+
+struct SweepSpec {
+    std::vector<std::string> levels;
+    std::vector<Layout> layouts;
+    std::vector<float> hpMultipliers{1.f};
+    std::vector<float> speedMultipliers{1.f};
+    std::vector<float> rewardMultipliers{1.f};
+    float tickRate = 60.f;
+    float maxSeconds = 900.f;
+};
+
+struct Combination {
+    std::size_t level = 0;
+    std::size_t layout = 0;
+    core::SimulationModifiers modifiers;
+};
+
+struct RunResult {
+    core::SimulationOutcome outcome = core::SimulationOutcome::Running;
+    int livesLost = 0;
+    int coins = 0;
+    int leakWave = 0;
+};
+
+struct Options {
+    std::string specPath;
+    std::string dataPath = "data";
+    std::string outPath;
+    std::string metricsPath;
+    unsigned threads = 0;
+};
+
+json loadJson(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open JSON file: " + path);
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return json::parse(content);
+}
+
+std::vector<float> parseFloats(const json& multipliers, const std::string& key) {
+    std::vector<float> out;
+    if (multipliers.contains(key)) {
+        for (const auto& value : multipliers.at(key)) {
+            out.push_back(value.get<float>());
+        }
+    }
+    if (out.empty()) out.push_back(1.f);
+    return out;
+}
+
+SweepSpec parseSpec(const json& j) {
+    SweepSpec spec;
+    for (const auto& level : j.at("levels")) {
+        spec.levels.push_back(level.get<std::string>());
+    }
+    for (const auto& layoutJson : j.at("layouts")) {
+        Layout layout;
+        layout.name = layoutJson.at("name").get<std::string>();
+        layout.fillTower = layoutJson.value("fill", std::string{});
+        if (layoutJson.contains("towers")) {
+            for (const auto& tower : layoutJson.at("towers")) {
+                const auto& cell = tower.at("cell");
+                layout.towers.push_back({tower.at("id").get<std::string>(),
+                                         {static_cast<int>(cell[0].get<float>()), static_cast<int>(cell[1].get<float>())}});
+            }
+        }
+        spec.layouts.push_back(std::move(layout));
+    }
+    if (j.contains("multipliers")) {
+        const auto& multipliers = j.at("multipliers");
+        spec.hpMultipliers = parseFloats(multipliers, "enemyHpMultiplier");
+        spec.speedMultipliers = parseFloats(multipliers, "enemySpeedMultiplier");
+        spec.rewardMultipliers = parseFloats(multipliers, "enemyRewardMultiplier");
+    }
+    if (j.value("seeds", 1) > 1) {
+        std::cerr << "[Sweep] Runs are deterministic, so 'seeds' is ignored and each combination runs once\n";
+    }
+    spec.tickRate = std::max(1.f, j.value("tickRate", 60.f));
+    spec.maxSeconds = j.value("maxSeconds", 900.f);
+    if (spec.levels.empty() || spec.layouts.empty()) {
+        throw std::runtime_error("Sweep spec needs at least one level and one layout");
+    }
+    return spec;
+}
+
+Options parseArgs(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--data") options.dataPath = next();
+        else if (arg == "--out") options.outPath = next();
+        else if (arg == "--metrics") options.metricsPath = next();
+        else if (arg == "--threads") options.threads = static_cast<unsigned>(std::stoul(next()));
+        else if (options.specPath.empty()) options.specPath = arg;
+        else throw std::runtime_error("Unexpected argument: " + arg);
+    }
+    if (options.specPath.empty()) {
+        throw std::runtime_error("Usage: towerdefense_sweep <spec.json> [--data DIR] [--out FILE.csv] [--threads N] [--metrics FILE.csv]");
+    }
+    return options;
+}
+
+std::vector<TowerOrder> buildOrder(const Layout& layout, const data::LevelDefinition& level) {
+    if (layout.fillTower.empty()) return layout.towers;
+    std::vector<TowerOrder> order;
+    for (const auto& cell : level.buildable) {
+        order.push_back({layout.fillTower, cell});
+    }
+    return order;
+}
+
+// Towers are placed in layout order as soon as they become affordable, so the
+// layout doubles as a build order.
+RunResult runOnce(const data::GameDatabase& db, const SweepSpec& spec, const Combination& combo) {
+    const auto& levelDef = db.levels.at(spec.levels[combo.level]);
+    const auto order = buildOrder(spec.layouts[combo.layout], levelDef);
+
+    core::Simulation sim(db);
+    sim.setModifiers(combo.modifiers);
+    sim.start(levelDef.id);
+
+    const float dt = 1.f / spec.tickRate;
+    const auto maxTicks = static_cast<long long>(spec.maxSeconds * spec.tickRate);
+    std::size_t nextTower = 0;
+    for (long long tick = 0; tick < maxTicks && sim.outcome() == core::SimulationOutcome::Running; ++tick) {
+        while (nextTower < order.size()) {
+            auto towerIt = db.towers.find(order[nextTower].towerId);
+            if (towerIt != db.towers.end() && sim.coins() < towerIt->second.cost) break;
+            sim.placeTowerAtCell(order[nextTower].towerId, order[nextTower].cell);
+            ++nextTower;
+        }
+        sim.tick(dt);
+    }
+
+    RunResult result;
+    result.outcome = sim.outcome();
+    result.livesLost = levelDef.startLives - std::max(0, sim.lives());
+    result.coins = sim.coins();
+    result.leakWave = sim.firstLeakWave();
+    return result;
+}
+
+void writeCsv(std::ostream& out, const SweepSpec& spec, const std::vector<Combination>& combos, const std::vector<RunResult>& results) {
+    out << "level,layout,enemyHpMultiplier,enemySpeedMultiplier,enemyRewardMultiplier,outcome,livesLost,coins,leakWave\n";
+    out << std::fixed << std::setprecision(4);
+    for (std::size_t c = 0; c < combos.size(); ++c) {
+        const auto& combo = combos[c];
+        const auto& result = results[c];
+        const char* outcome = result.outcome == core::SimulationOutcome::Victory  ? "victory"
+                              : result.outcome == core::SimulationOutcome::Defeat ? "defeat"
+                                                                                  : "timeout";
+        out << spec.levels[combo.level] << ',' << spec.layouts[combo.layout].name << ',' << combo.modifiers.enemyHp << ','
+            << combo.modifiers.enemySpeed << ',' << combo.modifiers.enemyReward << ',' << outcome << ','
+            << result.livesLost << ',' << result.coins << ',' << result.leakWave << '\n';
+    }
+}
+
+void appendMetrics(const std::string& path, const std::string& specPath, std::size_t sims, double seconds, unsigned threads) {
+    const bool writeHeader = !std::ifstream(path).good();
+    std::ofstream out(path, std::ios::app);
+    if (!out.is_open()) {
+        std::cerr << "[Sweep] Could not open metrics file '" << path << "'\n";
+        return;
+    }
+    if (writeHeader) {
+        out << "timestamp,spec,sims,seconds,threads,simsPerSecPerCore\n";
+    }
+    out << std::time(nullptr) << ',' << specPath << ',' << sims << ',' << seconds << ',' << threads << ','
+        << sims / seconds / threads << '\n';
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const Options options = parseArgs(argc, argv);
+        core::Trace::get().startFromEnvironment();
+        core::Trace::get().setThreadName("main");
+        const SweepSpec spec = parseSpec(loadJson(options.specPath));
+
+        core::DataLoader loader;
+        const data::GameDatabase db = loader.loadAll(options.dataPath);
+        for (const auto& level : spec.levels) {
+            if (!db.levels.count(level)) throw std::runtime_error("Unknown level in sweep spec: " + level);
+        }
+
+        std::vector<Combination> combos;
+        for (std::size_t level = 0; level < spec.levels.size(); ++level) {
+            for (std::size_t layout = 0; layout < spec.layouts.size(); ++layout) {
+                for (float hp : spec.hpMultipliers) {
+                    for (float speed : spec.speedMultipliers) {
+                        for (float reward : spec.rewardMultipliers) {
+                            combos.push_back({level, layout, {hp, speed, reward}});
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<RunResult> results(combos.size());
+        // The calling thread drains work alongside the pool, so it counts as one of the threads.
+        const unsigned threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+        const auto run = [&](std::size_t i) {
+            results[i] = runOnce(db, spec, combos[i]);
+        };
+        // JobSystem(0) would mean one worker per core, so a single thread runs without a pool.
+        std::optional<core::JobSystem> jobs;
+        if (threads > 1) jobs.emplace(threads - 1);
+        const auto begin = std::chrono::steady_clock::now();
+        if (jobs) {
+            jobs->parallelFor(results.size(), run);
+        } else {
+            for (std::size_t i = 0; i < results.size(); ++i) run(i);
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        if (options.outPath.empty()) {
+            writeCsv(std::cout, spec, combos, results);
+        } else {
+            std::ofstream out(options.outPath);
+            writeCsv(out, spec, combos, results);
+        }
+
+        std::cerr << "[Sweep] " << results.size() << " sims in " << seconds << "s on " << threads << " threads: "
+                  << results.size() / seconds / threads << " sims/sec/core\n";
+        if (!options.metricsPath.empty()) {
+            appendMetrics(options.metricsPath, options.specPath, results.size(), seconds, threads);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Sweep] " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,462 @@
+// Headless scenario runner and macro performance regression check.
+//
+// Usage: towerdefense_headless [--scenario FILE]... [--scenarios DIR] [--data DIR]
+//                              [--baseline FILE] [--update-baseline]
+//                              [--replay CAPTURE]... [--ticks N]
+//
+// Every scenario is simulated for a fixed number of ticks. The runner reports
+// p50/p99/max tick time, peak memory and the average time per simulation stage.
+// With --baseline the results are compared against stored numbers and the run
+// fails (exit code 1) when a metric exceeds its tolerance. See perf/.
+//
+// --replay restores the simulation snapshot of a hitch capture written by the
+// game (captures/hitch_*.json) and re-runs it with the captured time step.
+
+#include "core/DataLoader.hpp"
+#include "core/Simulation.hpp"
+#include "core/Trace.hpp"
+#include "math/Path.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+using nlohmann::json;
+
+struct TowerBatch {
+    std::string id;
+    int count = 0;
+};
+
+struct EnemyStream {
+    std::string type;
+    int count = 0;
+    int perTick = 1;
+};
+
+struct Scenario {
+    std::string name;
+    std::string level;
+    int ticks = 600;
+    float tickRate = 60.f;
+    bool levelWaves = true;
+    int lives = 0;
+    int coins = 0;
+    std::string fillTower;
+    std::vector<TowerBatch> towers;
+    std::vector<EnemyStream> enemies;
+};
+
+struct ScenarioResult {
+    std::string name;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double meanMs = 0.0;
+    double peakMemoryMb = 0.0;
+    std::size_t peakEntities = 0;
+    core::SimulationStageTimes stageMs{}; // average per tick
+};
+
+struct Tolerances {
+    double p50 = 0.3;
+    double p99 = 0.75;
+    double max = 2.0;
+    double peakMemory = 0.25;
+    double minDeltaMs = 0.05;
+};
+
+struct Options {
+    std::vector<std::string> scenarios;
+    std::string dataPath = "data";
+    std::string baselinePath;
+    bool updateBaseline = false;
+    std::vector<std::string> replays;
+    int replayTicks = 60;
+};
+
+json loadJson(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open JSON file: " + path);
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return json::parse(content);
+}
+
+Scenario parseScenario(const json& j) {
+    Scenario s;
+    s.name = j.at("name").get<std::string>();
+    s.level = j.at("level").get<std::string>();
+    s.ticks = j.value("ticks", 600);
+    s.tickRate = std::max(1.f, j.value("tickRate", 60.f));
+    s.levelWaves = j.value("levelWaves", true);
+    s.lives = j.value("lives", 0);
+    s.coins = j.value("coins", 0);
+    s.fillTower = j.value("fill", std::string{});
+    if (j.contains("towers")) {
+        for (const auto& tower : j.at("towers")) {
+            s.towers.push_back({tower.at("id").get<std::string>(), tower.at("count").get<int>()});
+        }
+    }
+    if (j.contains("enemies")) {
+        for (const auto& enemy : j.at("enemies")) {
+            s.enemies.push_back({enemy.at("type").get<std::string>(), enemy.at("count").get<int>(),
+                                 std::max(1, enemy.value("perTick", 1))});
+        }
+    }
+    return s;
+}
+
+// Peak resident set size since the last reset, in bytes.
+std::size_t peakMemoryBytes() {
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return static_cast<std::size_t>(std::stoull(line.substr(6))) * 1024;
+        }
+    }
+    return 0;
+#elif defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    return 0;
+#endif
+}
+
+void resetPeakMemory() {
+#if defined(__linux__)
+    // Writing 5 resets VmHWM to the current RSS (Linux 4.0+); harmless if unsupported.
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+#endif
+}
+
+// Spreads towers along the level paths, alternating sides, ignoring cost and buildable cells.
+void placeTowers(core::Simulation& sim, const TowerBatch& batch) {
+    const auto& paths = sim.level().paths;
+    if (paths.empty() || batch.count <= 0) return;
+    const float offset = static_cast<float>(sim.level().definition.tileSize);
+    for (int i = 0; i < batch.count; ++i) {
+        const auto& path = paths[static_cast<std::size_t>(i) % paths.size()];
+        if (path.points.size() < 2) continue;
+        const int perPath = std::max(1, batch.count / static_cast<int>(paths.size()));
+        const float along = static_cast<float>(i / static_cast<int>(paths.size()) % perPath) / static_cast<float>(perPath) *
+                            static_cast<float>(path.points.size() - 1);
+        const int segment = static_cast<int>(along);
+        sf::Vector2f position = math::samplePath(path, segment, along - static_cast<float>(segment));
+        position.y += (i % 2 == 0) ? offset : -offset;
+        sim.spawnTowerAt(batch.id, position);
+    }
+}
+
+ScenarioResult runScenario(const data::GameDatabase& db, const Scenario& scenario) {
+    if (!db.levels.count(scenario.level)) {
+        throw std::runtime_error("Scenario '" + scenario.name + "' uses unknown level " + scenario.level);
+    }
+    resetPeakMemory();
+
+    core::Simulation sim(db);
+    sim.start(scenario.level);
+    sim.setAutoWaves(scenario.levelWaves);
+    if (scenario.lives > 0) sim.setLives(scenario.lives);
+    if (scenario.coins > 0) sim.setCoins(scenario.coins);
+    if (!scenario.fillTower.empty()) {
+        for (const auto& cell : sim.level().definition.buildable) {
+            sim.placeTowerAtCell(scenario.fillTower, cell);
+        }
+    }
+    for (const auto& batch : scenario.towers) {
+        placeTowers(sim, batch);
+    }
+
+    std::vector<int> remaining;
+    for (const auto& stream : scenario.enemies) remaining.push_back(stream.count);
+
+    core::SimulationStageTimes stageTimes{};
+    core::SimulationStageTimes stageTotals{};
+    sim.setStageTimes(&stageTimes);
+
+    std::vector<double> tickMs;
+    tickMs.reserve(static_cast<std::size_t>(std::max(0, scenario.ticks)));
+    std::size_t peakEntities = 0;
+    const float dt = 1.f / scenario.tickRate;
+    for (int tick = 0; tick < scenario.ticks; ++tick) {
+        const auto begin = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < scenario.enemies.size(); ++i) {
+            const int batch = std::min(remaining[i], scenario.enemies[i].perTick);
+            if (batch > 0) {
+                sim.spawnEnemies(scenario.enemies[i].type, batch);
+                remaining[i] -= batch;
+            }
+        }
+        sim.tick(dt);
+        tickMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+        for (std::size_t s = 0; s < core::kSimulationStageCount; ++s) stageTotals[s] += stageTimes[s];
+        peakEntities = std::max(peakEntities, sim.registry().m_transforms.size());
+        if (sim.outcome() != core::SimulationOutcome::Running) break;
+    }
+
+    ScenarioResult result;
+    result.name = scenario.name;
+    result.peakEntities = peakEntities;
+    result.peakMemoryMb = static_cast<double>(peakMemoryBytes()) / (1024.0 * 1024.0);
+    if (!tickMs.empty()) {
+        const double ticks = static_cast<double>(tickMs.size());
+        double sum = 0.0;
+        for (double ms : tickMs) sum += ms;
+        result.meanMs = sum / ticks;
+        for (std::size_t s = 0; s < core::kSimulationStageCount; ++s) result.stageMs[s] = stageTotals[s] * 1000.0 / ticks;
+        std::sort(tickMs.begin(), tickMs.end());
+        auto percentile = [&](double p) {
+            const auto index = static_cast<std::size_t>(p * (ticks - 1.0) + 0.5);
+            return tickMs[std::min(index, tickMs.size() - 1)];
+        };
+        result.p50Ms = percentile(0.50);
+        result.p99Ms = percentile(0.99);
+        result.maxMs = tickMs.back();
+    }
+    return result;
+}
+
+json resultToJson(const ScenarioResult& r) {
+    json::object_t stages;
+    for (std::size_t s = 0; s < core::kSimulationStageCount; ++s) {
+        stages[core::simulationStageName(static_cast<core::SimulationStage>(s))] = r.stageMs[s];
+    }
+    return json{{"p50Ms", r.p50Ms},
+                {"p99Ms", r.p99Ms},
+                {"maxMs", r.maxMs},
+                {"meanMs", r.meanMs},
+                {"peakMemoryMb", r.peakMemoryMb},
+                {"stagesMs", json(stages)}};
+}
+
+void printResult(const ScenarioResult& r) {
+    std::cout << std::fixed << std::setprecision(3) << r.name << ": p50 " << r.p50Ms << " ms, p99 " << r.p99Ms
+              << " ms, max " << r.maxMs << " ms, mean " << r.meanMs << " ms, peak " << std::setprecision(1)
+              << r.peakMemoryMb << " MB, " << r.peakEntities << " entities\n";
+}
+
+void printBreakdown(const ScenarioResult& current, const json& baseline) {
+    const json* stages = baseline.contains("stagesMs") ? &baseline.at("stagesMs") : nullptr;
+    std::cout << "    " << std::left << std::setw(14) << "stage" << std::right << std::setw(14) << "baseline ms"
+              << std::setw(14) << "current ms" << std::setw(12) << "delta ms" << std::setw(10) << "share" << "\n";
+    for (std::size_t s = 0; s < core::kSimulationStageCount; ++s) {
+        const char* name = core::simulationStageName(static_cast<core::SimulationStage>(s));
+        const double before = (stages && stages->contains(name)) ? stages->at(name).get<double>() : 0.0;
+        const double now = current.stageMs[s];
+        const double share = current.meanMs > 0.0 ? now / current.meanMs * 100.0 : 0.0;
+        std::cout << "    " << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(4)
+                  << std::setw(14) << before << std::setw(14) << now << std::setw(12) << (now - before)
+                  << std::setw(9) << std::setprecision(1) << share << "%\n";
+    }
+}
+
+// Returns false when any metric exceeds baseline * (1 + tolerance).
+bool compareWithBaseline(const ScenarioResult& current, const json& baseline, const Tolerances& tol) {
+    struct Metric {
+        const char* key;
+        double value;
+        double tolerance;
+        bool isTime;
+    };
+    const Metric metrics[] = {{"p50Ms", current.p50Ms, tol.p50, true},
+                              {"p99Ms", current.p99Ms, tol.p99, true},
+                              {"maxMs", current.maxMs, tol.max, true},
+                              {"peakMemoryMb", current.peakMemoryMb, tol.peakMemory, false}};
+    bool ok = true;
+    for (const auto& metric : metrics) {
+        if (!baseline.contains(metric.key)) continue;
+        const double before = baseline.at(metric.key).get<double>();
+        double limit = before * (1.0 + metric.tolerance);
+        if (metric.isTime) limit = std::max(limit, before + tol.minDeltaMs);
+        if (metric.value > limit) {
+            std::cout << "  REGRESSION " << metric.key << ": " << std::setprecision(3) << metric.value << " > limit "
+                      << limit << " (baseline " << before << ", tolerance " << metric.tolerance * 100.0 << "%)\n";
+            ok = false;
+        }
+    }
+    if (!ok) printBreakdown(current, baseline);
+    return ok;
+}
+
+Tolerances parseTolerances(const json& baseline) {
+    Tolerances tol;
+    if (!baseline.contains("tolerances")) return tol;
+    const auto& t = baseline.at("tolerances");
+    tol.p50 = t.value("p50", tol.p50);
+    tol.p99 = t.value("p99", tol.p99);
+    tol.max = t.value("max", tol.max);
+    tol.peakMemory = t.value("peakMemory", tol.peakMemory);
+    tol.minDeltaMs = t.value("minDeltaMs", tol.minDeltaMs);
+    return tol;
+}
+
+void writeBaseline(const std::string& path, const std::vector<ScenarioResult>& results, const Tolerances& tol) {
+    json::object_t scenarios;
+    for (const auto& r : results) scenarios[r.name] = resultToJson(r);
+    const json baseline{{"tolerances", json{{"p50", tol.p50},
+                                            {"p99", tol.p99},
+                                            {"max", tol.max},
+                                            {"peakMemory", tol.peakMemory},
+                                            {"minDeltaMs", tol.minDeltaMs}}},
+                        {"scenarios", json(scenarios)}};
+    std::ofstream file(path);
+    file << baseline.dump(2) << "\n";
+}
+
+void printStages(const core::SimulationStageTimes& stages) {
+    for (std::size_t s = 0; s < core::kSimulationStageCount; ++s) {
+        std::cout << "    " << std::left << std::setw(14) << core::simulationStageName(static_cast<core::SimulationStage>(s))
+                  << std::right << std::fixed << std::setprecision(4) << std::setw(12) << stages[s] * 1000.0 << " ms\n";
+    }
+}
+
+void replayCapture(const data::GameDatabase& db, const std::string& path, int ticks) {
+    const json capture = loadJson(path);
+    core::Simulation sim(db);
+    if (!sim.restore(capture.at("simulation"))) {
+        throw std::runtime_error("Capture " + path + " references an unknown level");
+    }
+    const float dt = capture.at("dt").get<float>() * static_cast<float>(capture.value("speed", 1));
+    std::cout << path << ": level " << sim.levelId() << ", wave " << sim.waveIndex() << ", "
+              << sim.registry().m_enemyStats.size() << " enemies, " << sim.registry().m_towerStats.size()
+              << " towers, recorded tick " << std::fixed << std::setprecision(3) << capture.value("tickMs", 0.0)
+              << " ms (budget " << capture.value("budgetMs", 0.0) << " ms), " << capture.at("inputs").size()
+              << " recent inputs\n";
+
+    core::SimulationStageTimes stageTimes{};
+    core::SimulationStageTimes slowestStages{};
+    sim.setStageTimes(&stageTimes);
+    std::vector<double> tickMs;
+    for (int tick = 0; tick < ticks && sim.outcome() == core::SimulationOutcome::Running; ++tick) {
+        const auto begin = std::chrono::steady_clock::now();
+        sim.tick(dt);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        if (tickMs.empty() || ms > *std::max_element(tickMs.begin(), tickMs.end())) slowestStages = stageTimes;
+        tickMs.push_back(ms);
+    }
+    if (tickMs.empty()) return;
+    const double first = tickMs.front();
+    std::sort(tickMs.begin(), tickMs.end());
+    std::cout << "  replayed " << tickMs.size() << " ticks of " << dt * 1000.f << " ms: first " << first
+              << " ms, p50 " << tickMs[tickMs.size() / 2] << " ms, max " << tickMs.back() << " ms\n";
+    std::cout << "  slowest tick by stage:\n";
+    printStages(slowestStages);
+}
+
+Options parseArgs(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--scenario") {
+            options.scenarios.push_back(next());
+        } else if (arg == "--scenarios") {
+            std::vector<std::string> found;
+            for (const auto& entry : std::filesystem::directory_iterator(next())) {
+                if (entry.path().extension() == ".json") found.push_back(entry.path().string());
+            }
+            std::sort(found.begin(), found.end());
+            options.scenarios.insert(options.scenarios.end(), found.begin(), found.end());
+        } else if (arg == "--data") {
+            options.dataPath = next();
+        } else if (arg == "--baseline") {
+            options.baselinePath = next();
+        } else if (arg == "--replay") {
+            options.replays.push_back(next());
+        } else if (arg == "--ticks") {
+            options.replayTicks = std::max(1, std::stoi(next()));
+        } else if (arg == "--update-baseline") {
+            options.updateBaseline = true;
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
+        }
+    }
+    if (options.scenarios.empty() && options.replays.empty()) {
+        throw std::runtime_error("Usage: towerdefense_headless [--scenario FILE]... [--scenarios DIR] [--data DIR] "
+                                 "[--baseline FILE] [--update-baseline] [--replay CAPTURE]... [--ticks N]");
+    }
+    if (options.updateBaseline && options.baselinePath.empty()) {
+        throw std::runtime_error("--update-baseline needs --baseline FILE");
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const Options options = parseArgs(argc, argv);
+        core::Trace::get().startFromEnvironment();
+        core::Trace::get().setThreadName("main");
+        core::DataLoader loader;
+        const data::GameDatabase db = loader.loadAll(options.dataPath);
+
+        for (const auto& path : options.replays) {
+            replayCapture(db, path, options.replayTicks);
+        }
+
+        std::vector<ScenarioResult> results;
+        for (const auto& path : options.scenarios) {
+            const Scenario scenario = parseScenario(loadJson(path));
+            results.push_back(runScenario(db, scenario));
+            printResult(results.back());
+        }
+
+        if (options.baselinePath.empty()) return 0;
+
+        const bool haveBaseline = std::filesystem::exists(options.baselinePath);
+        const json baseline = haveBaseline ? loadJson(options.baselinePath) : json{};
+        const Tolerances tol = haveBaseline ? parseTolerances(baseline) : Tolerances{};
+        if (options.updateBaseline) {
+            writeBaseline(options.baselinePath, results, tol);
+            std::cout << "Baseline written to " << options.baselinePath << "\n";
+            return 0;
+        }
+        if (!haveBaseline) {
+            throw std::runtime_error("Baseline file not found: " + options.baselinePath);
+        }
+
+        bool ok = true;
+        const auto& stored = baseline.at("scenarios");
+        for (const auto& result : results) {
+            if (!stored.contains(result.name)) {
+                std::cout << result.name << ": no baseline entry, skipped\n";
+                continue;
+            }
+            std::cout << result.name << ":\n";
+            if (compareWithBaseline(result, stored.at(result.name), tol)) {
+                std::cout << "  ok\n";
+            } else {
+                ok = false;
+            }
+        }
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "[Headless] " << e.what() << "\n";
+        return 2;
+    }
+}